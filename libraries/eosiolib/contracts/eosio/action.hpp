@@ -381,8 +381,9 @@ namespace eosio {
        * Send the action as inline action
        */
       void send() const {
-         auto serialize = pack(*this);
-         internal_use_do_not_use::send_inline(serialize.data(), serialize.size());
+         with_packed(*this, [](const char* serialize, size_t size) {
+            internal_use_do_not_use::send_inline(const_cast<char*>(serialize), size);
+         });
       }
 
       /**
@@ -392,8 +393,9 @@ namespace eosio {
        */
       void send_context_free() const {
          eosio::check( authorization.size() == 0, "context free actions cannot have authorizations");
-         auto serialize = pack(*this);
-         internal_use_do_not_use::send_context_free_inline(serialize.data(), serialize.size());
+         with_packed(*this, [](const char* serialize, size_t size) {
+            internal_use_do_not_use::send_context_free_inline(const_cast<char*>(serialize), size);
+         });
       }
 
       /**
@@ -409,6 +411,58 @@ namespace eosio {
 
    };
 
+   /// @cond INTERNAL
+   namespace detail {
+      // Serialize an action with the payload `args` straight into one buffer, in the layout of `pack(action)`,
+      // and pass it to `send`. The payload size is computed once and no `action::data` is built.
+      template <typename Send, typename... Args>
+      void send_packed_action( Send&& send, name account, name action_name, const std::vector<permission_level>& auths, const Args&... args ) {
+         const auto payload = std::forward_as_tuple(args...);
+         const size_t payload_size = pack_size(payload);
+         const size_t size = pack_size(account) + pack_size(action_name) + pack_size(auths) +
+                             pack_size(unsigned_int(payload_size)) + payload_size;
+         with_scratch_buffer<512>(size, [&](char* buffer) {
+            datastream<char*> ds(buffer, size);
+            ds << account << action_name << auths << unsigned_int(payload_size) << payload;
+            send(buffer, size);
+         });
+      }
+   }
+   /// @endcond
+
+   /**
+    * Send an inline action whose payload is the serialization of `args`
+    *
+    * @details Same as `action(auths, account, action_name, std::make_tuple(args...)).send()`, but the action
+    * is serialized directly into a single buffer, on the stack when it is small.
+    * @ingroup action
+    * @param account - The name of the account this action is intended for (action receiver)
+    * @param action_name - The name of the action
+    * @param auths - The list of permissions that authorize this action
+    * @param args - The action arguments
+    */
+   template <typename... Args>
+   void send_inline_action( name account, name action_name, const std::vector<permission_level>& auths, const Args&... args ) {
+      detail::send_packed_action([](char* serialize, size_t size) { internal_use_do_not_use::send_inline(serialize, size); },
+                                 account, action_name, auths, args...);
+   }
+
+   /**
+    * Send an inline context free action whose payload is the serialization of `args`
+    *
+    * @details Same as `action({}, account, action_name, std::make_tuple(args...)).send_context_free()`, but the
+    * action is serialized directly into a single buffer, on the stack when it is small.
+    * @ingroup action
+    * @param account - The name of the account this action is intended for (action receiver)
+    * @param action_name - The name of the action
+    * @param args - The action arguments
+    */
+   template <typename... Args>
+   void send_context_free_inline_action( name account, name action_name, const Args&... args ) {
+      detail::send_packed_action([](char* serialize, size_t size) { internal_use_do_not_use::send_context_free_inline(serialize, size); },
+                                 account, action_name, {}, args...);
+   }
+
    /**
     * Wrapper for an action object.
     *
@@ -461,12 +515,15 @@ namespace eosio {
       }
       template <typename... Args>
       void send(Args&&... args)const {
-         to_action(std::forward<Args>(args)...).send();
+         static_assert(detail::type_check<Action, Args...>());
+         send_inline_action(code_name, action_name, permissions, detail::deduced<Action>{std::forward<Args>(args)...});
       }
 
       template <typename... Args>
       void send_context_free(Args&&... args)const {
-         to_action(std::forward<Args>(args)...).send_context_free();
+         static_assert(detail::type_check<Action, Args...>());
+         eosio::check( permissions.size() == 0, "context free actions cannot have authorizations");
+         send_context_free_inline_action(code_name, action_name, detail::deduced<Action>{std::forward<Args>(args)...});
       }
 
    };
@@ -508,12 +565,17 @@ namespace eosio {
 
       template <size_t Variant, typename... Args>
       void send(Args&&... args)const {
-         to_action<Variant>(std::forward<Args>(args)...).send();
+         static_assert(detail::type_check<detail::get_nth<Variant, Actions...>::value, Args...>());
+         send_inline_action(code_name, action_name, permissions, unsigned_int(Variant),
+                            detail::deduced<detail::get_nth<Variant, Actions...>::value>{std::forward<Args>(args)...});
       }
 
       template <size_t Variant, typename... Args>
       void send_context_free(Args&&... args) const {
-         to_action<Variant>(std::forward<Args>(args)...).send_context_free();
+         static_assert(detail::type_check<detail::get_nth<Variant, Actions...>::value, Args...>());
+         eosio::check( permissions.size() == 0, "context free actions cannot have authorizations");
+         send_context_free_inline_action(code_name, action_name, unsigned_int(Variant),
+                                         detail::deduced<detail::get_nth<Variant, Actions...>::value>{std::forward<Args>(args)...});
       }
 
    };
@@ -522,7 +584,7 @@ namespace eosio {
    void dispatch_inline( name code, name act,
                          std::vector<permission_level> perms,
                          std::tuple<Args...> args ) {
-      action( perms, code, act, std::move(args) ).send();
+      send_inline_action( code, act, perms, args );
    }
 
    template<typename, name::raw>
@@ -2,6 +2,7 @@
  *  @file
  */
 #pragma once
+#include <algorithm>
 #include <cstdlib>
 #include <type_traits>
 
@@ -96,6 +97,8 @@ namespace eosio {
       {}
 
       static constexpr eosio::hash_id function_name = eosio::hash_id(Func_Name);
+      static constexpr auto function_ref = Func_Ref;
+      static constexpr size_t max_stack_buffer_size = 512;
       eosio::name receiver {};
 
       using orig_ret_type = typename detail::function_traits<decltype(Func_Ref)>::return_type;
@@ -121,10 +124,15 @@ namespace eosio {
 
          call_data_header header{ .version   = 0,
                                   .func_name = function_name.id };
- 
-         const std::vector<char> data{ pack(std::forward_as_tuple(header, detail::deduced<Func_Ref>{std::forward<Args>(args)...})) };
+         const detail::deduced<Func_Ref> call_args{std::forward<Args>(args)...};
 
-         auto ret_val_size = internal_use_do_not_use::call(receiver.value, flags, data.data(), data.size());
+         // header and arguments are packed on the stack, or into the scratch buffer reused for the whole action
+         const size_t data_size = pack_size(header) + pack_size(call_args);
+         auto ret_val_size = detail::with_scratch_buffer<max_stack_buffer_size>(data_size, [&](char* data) {
+            datastream<char*> ds(data, data_size);
+            ds << header << call_args;
+            return internal_use_do_not_use::call(receiver.value, flags, data, data_size);
+         });
 
          if (ret_val_size < 0) {  // the receiver does not support sync calls
             if constexpr (Support_Mode == support_mode::abort_op) {
@@ -141,10 +149,11 @@ namespace eosio {
             if constexpr (Support_Mode == support_mode::no_op && std::is_void<orig_ret_type>::value) {
                return void_call{};
             } else {
-               constexpr size_t max_stack_buffer_size = 512;
-               char* buffer = (char*)(max_stack_buffer_size < ret_val_size ? malloc(ret_val_size) : alloca(ret_val_size)); // intentionally no `free()` is called. the memory will be freed at the end of callers wasm execution. 
-               internal_use_do_not_use::get_call_return_value(buffer, ret_val_size);
-               orig_ret_type ret_val = unpack<orig_ret_type>(buffer, ret_val_size);
+               // the return value is unpacked before the buffer is released, nothing is kept per call
+               orig_ret_type ret_val = detail::with_scratch_buffer<max_stack_buffer_size>(ret_val_size, [&](char* buffer) {
+                  internal_use_do_not_use::get_call_return_value(buffer, ret_val_size);
+                  return unpack<orig_ret_type>(buffer, ret_val_size);
+               });
 
                if constexpr (Support_Mode == support_mode::no_op) {
                   return std::make_optional(ret_val);
@@ -155,4 +164,126 @@ namespace eosio {
          }
       }
    };
+
+   /**
+    * Builder of a batch of sync calls to a single receiver, made in one call
+    *
+    * @brief The calls are executed in order by a sync call cdt-ld generates in every contract with sync calls,
+    * and the results are returned together. A failing call aborts the whole batch.
+    * Example:
+    * @code
+    * using get_func = call_wrapper<"get"_i, &callee::get>;
+    * using put_func = call_wrapper<"put"_i, &callee::put>;
+    * auto results = call_batch{"callee"_n}.add<put_func>(key, 1).add<get_func>(key).send();
+    * auto value   = call_batch::result_as<get_func>(results[1]);
+    * @endcode
+    */
+   class call_batch {
+   public:
+      // name of the generated sync call executing batches
+      static constexpr eosio::hash_id batch_function_name = eosio::hash_id("eosio_call_batch");
+      static constexpr size_t max_stack_buffer_size = 512;
+
+      explicit call_batch(eosio::name receiver, access_mode mode = access_mode::read_write)
+         : receiver(receiver), mode(mode) {}
+
+      /**
+       * Add a call to the batch
+       *
+       * @tparam Wrapper - The `call_wrapper` of the function to call
+       * @param args - The arguments of the call
+       * @return call_batch& - This batch
+       */
+      template <typename Wrapper, typename... Args>
+      call_batch& add(Args&&... args) {
+         static_assert(detail::type_check<Wrapper::function_ref, Args...>());
+         const call_data_header header{ .version   = 0,
+                                        .func_name = Wrapper::function_name.id };
+         const detail::deduced<Wrapper::function_ref> call_args{std::forward<Args>(args)...};
+
+         const size_t offset = calls.size();
+         calls.resize(offset + pack_size(header) + pack_size(call_args));
+         datastream<char*> ds(calls.data() + offset, calls.size() - offset);
+         ds << header << call_args;
+         ++count;
+         return *this;
+      }
+
+      /**
+       * Make the batched calls
+       *
+       * @return std::vector<std::vector<char>> - The packed result of every call, empty for `void` functions
+       */
+      std::vector<std::vector<char>> send()const {
+         const uint64_t flags = mode == access_mode::read_only ? 0x01 : 0x00;
+         const call_data_header header{ .version   = 0,
+                                        .func_name = batch_function_name.id };
+         const unsigned_int batch_size = count;
+
+         const size_t data_size = pack_size(header) + pack_size(batch_size) + calls.size();
+         auto ret_val_size = detail::with_scratch_buffer<max_stack_buffer_size>(data_size, [&](char* data) {
+            datastream<char*> ds(data, data_size);
+            ds << header << batch_size;
+            ds.write(calls.data(), calls.size());
+            return internal_use_do_not_use::call(receiver.value, flags, data, data_size);
+         });
+         check(ret_val_size >= 0, "receiver does not support sync call");
+
+         return detail::with_scratch_buffer<max_stack_buffer_size>(ret_val_size, [&](char* buffer) {
+            internal_use_do_not_use::get_call_return_value(buffer, ret_val_size);
+            return unpack<std::vector<std::vector<char>>>(buffer, ret_val_size);
+         });
+      }
+
+      /**
+       * Unpack the result of a call of the batch
+       *
+       * @tparam Wrapper - The `call_wrapper` of the called function
+       * @param packed_result - The packed result returned by `send()`
+       */
+      template <typename Wrapper>
+      static typename Wrapper::orig_ret_type result_as(const std::vector<char>& packed_result) {
+         return unpack<typename Wrapper::orig_ret_type>(packed_result);
+      }
+
+      eosio::name receiver {};
+      access_mode mode = access_mode::read_write;
+
+   private:
+      std::vector<char> calls;
+      uint32_t          count = 0;
+   };
+
+   namespace detail {
+      // Entry generated for a sync call executed in a batch: reads the arguments from `ds`, a
+      // `datastream<const char*>`, and packs the result into `packed_result`, a `std::vector<char>`
+      using batch_call_entry = void (*)(uint64_t receiver, void* ds, void* packed_result);
+
+      /**
+       * Execute a batch built by `call_batch` and set the packed results as the call return value
+       *
+       * @param ids - The sorted hash_ids of the sync calls of the contract
+       * @param entries - The entry of the call of each hash_id
+       * @param count - The number of sync calls
+       */
+      inline void execute_call_batch(uint64_t receiver, const void* data, size_t data_size,
+                                     const uint64_t* ids, const batch_call_entry* entries, size_t count) {
+         datastream<const char*> ds{static_cast<const char*>(data), data_size};
+         call_data_header header;
+         unsigned_int batch_size;
+         ds >> header >> batch_size;
+         // every call starts with its header, the results are not sized from an impossible count
+         check(batch_size.value <= ds.remaining() / pack_size(call_data_header{}), "sync call batch is truncated");
+
+         std::vector<std::vector<char>> results(batch_size.value);
+         for (auto& packed_result : results) {
+            call_data_header call_header;
+            ds >> call_header;
+            const uint64_t* id = std::lower_bound(ids, ids + count, call_header.func_name);
+            check(id != ids + count && *id == call_header.func_name, "unknown sync call in batch");
+            entries[id - ids](receiver, &ds, &packed_result);
+         }
+         with_packed(results, [](const char* packed, size_t size) { set_call_return_value((void*)packed, size); });
+      }
+   } // namespace detail
 } // namespace eosio
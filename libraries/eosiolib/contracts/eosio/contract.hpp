@@ -3,6 +3,10 @@
 #include "../../core/eosio/name.hpp"
 #include "../../core/eosio/datastream.hpp"
 
+#if __cplusplus > 201703L
+#include <span>
+#endif
+
 
 /**
  * @defgroup contract Contract
@@ -81,6 +85,19 @@ class contract {
        */
       inline const datastream<const char*>& get_datastream()const { return _ds; }
 
+#if __cplusplus > 201703L
+      /**
+       * Get the raw data of the action (or of the sync call, including its header) being executed
+       *
+       * @details The span points into the buffer the dispatcher read the data into, which stays
+       * alive until the action handler returns, so it can be read without copying
+       * @return std::span<const char> - The data of the current action
+       */
+      inline std::span<const char> get_action_data()const {
+         return std::span<const char>(_ds.pos() - _ds.tellp(), _ds.tellp() + _ds.remaining());
+      }
+#endif
+
       /**
        * Whether this contract is for a sync call
        *
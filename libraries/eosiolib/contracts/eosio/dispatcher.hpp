@@ -1,8 +1,10 @@
 #pragma once
 #include "action.hpp"
+#include "../../core/eosio/perfect_hash.hpp"
 
 #include <bluegrass/meta/preprocessor.hpp>
 #include <tuple>
+#include <utility>
 
 namespace eosio {
 
@@ -60,6 +62,8 @@ namespace eosio {
     * @param obj - The contract object that has the correponding action handler
     * @param func - The action handler
     * @return true
+    * @note The action data buffer stays alive until the handler returns, so `std::string_view`
+    * and `std::span<const char>` parameters refer to the action data without copying it
     */
    template<typename T, typename... Args>
    bool execute_action( name self, name code, void (T::*func)(Args...)  ) {
@@ -79,8 +83,10 @@ namespace eosio {
 
       T inst(self, code, ds);
 
-      auto f2 = [&]( auto... a ){
-         ((&inst)->*func)( a... );
+      // forward each unpacked argument with the value category of the handler's
+      // parameter so that by-value arguments are moved instead of copied
+      auto f2 = [&]( auto&... a ){
+         ((&inst)->*func)( std::forward<Args>(a)... );
       };
 
       std::apply( f2, args );
@@ -98,15 +104,25 @@ namespace eosio {
        eosio::execute_action( eosio::name(receiver), eosio::name(code), &OP::elem ); \
        break;
 
- // Helper macro for EOSIO_DISPATCH
+ // Helper macro for custom apply functions
  #define EOSIO_DISPATCH_HELPER( TYPE,  MEMBERS ) \
     BLUEGRASS_META_FOREACH_SEQ( EOSIO_DISPATCH_INTERNAL, TYPE, MEMBERS )
 
+ // Helper macros for the dispatch table of EOSIO_DISPATCH
+ #define EOSIO_DISPATCH_NAME( OP, elem ) \
+    eosio::name( BLUEGRASS_META_STRINGIZE(elem) ).value,
+
+ #define EOSIO_DISPATCH_HANDLER( OP, elem ) \
+    []( eosio::name self, eosio::name code ) { eosio::execute_action( self, code, &OP::elem ); },
+
 /// @endcond
 
 /**
  * Convenient macro to create contract apply handler
  *
+ * The action is looked up in a perfect hash table over the action names built at compile time,
+ * so dispatching costs one hash and one compare regardless of the number of actions.
+ *
  * @ingroup dispatcher
  * @note To be able to use this macro, the contract needs to be derived from eosio::contract
  * @param TYPE - The class name of the contract
@@ -122,9 +138,15 @@ extern "C" { \
    [[eosio::wasm_entry]] \
    void apply( uint64_t receiver, uint64_t code, uint64_t action ) { \
       if( code == receiver ) { \
-         switch( action ) { \
-            EOSIO_DISPATCH_HELPER( TYPE, MEMBERS ) \
-         } \
+         static constexpr uint64_t names[] = { BLUEGRASS_META_FOREACH_SEQ( EOSIO_DISPATCH_NAME, TYPE, MEMBERS ) }; \
+         static constexpr auto table = eosio::detail::make_perfect_hash( names ); \
+         static_assert( !table.duplicate_keys, "EOSIO_DISPATCH: action names must be unique" ); \
+         static_assert( !table.seed_not_found, "EOSIO_DISPATCH: no perfect hash found for the action names" ); \
+         static constexpr void (*handlers[])( eosio::name, eosio::name ) = { \
+            BLUEGRASS_META_FOREACH_SEQ( EOSIO_DISPATCH_HANDLER, TYPE, MEMBERS ) \
+         }; \
+         if( int32_t i = table.find( action ); i >= 0 ) \
+            handlers[i]( eosio::name(receiver), eosio::name(code) ); \
          /* does not allow destructor of thiscontract to run: eosio_exit(0); */ \
       } \
    } \
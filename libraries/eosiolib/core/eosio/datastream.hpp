@@ -14,9 +14,14 @@
 #include <set>
 #include <map>
 #include <string>
+#include <string_view>
 #include <optional>
 #include <variant>
+#if __cplusplus > 201703L
+#include <span>
+#endif
 
+#include <stdlib.h>
 #include <string.h>
 
 namespace eosio {
@@ -516,12 +521,11 @@ datastream<Stream>& operator << ( datastream<Stream>& ds, const std::string& v )
  */
 template<typename Stream>
 datastream<Stream>& operator >> ( datastream<Stream>& ds, std::string& v ) {
-   std::vector<char> tmp;
-   ds >> tmp;
-   if( tmp.size() )
-      v = std::string(tmp.data(),tmp.data()+tmp.size());
-   else
-      v = std::string();
+   unsigned_int s;
+   ds >> s;
+   v.resize(s.value);
+   if( s.value )
+      ds.read(v.data(), v.size());
    return ds;
 }
 
@@ -835,6 +839,81 @@ datastream<Stream>& operator >> ( datastream<Stream>& ds, std::basic_string<uint
    return ds;
 }
 
+/**
+ *  Serialize a basic_string_view<T>, in the same format as a basic_string<T>
+ *
+ *  @param ds - The stream to write
+ *  @param s - The value to serialize
+ *  @tparam Stream - Type of datastream buffer
+ *  @tparam T - Type of the object contained in the basic_string_view
+ *  @return datastream<Stream>& - Reference to the datastream
+ */
+template<typename Stream, typename T>
+datastream<Stream>& operator << ( datastream<Stream>& ds, const std::basic_string_view<T>& s ) {
+   ds << unsigned_int(s.size());
+   if (s.size())
+      ds.write(s.data(), s.size()*sizeof(T));
+   return ds;
+}
+
+/**
+ *  Deserialize a string into a string_view pointing into the buffer of the stream
+ *
+ *  @details No data is copied, the view is only valid as long as the buffer of the stream is
+ *  @param ds - The stream to read
+ *  @param s - The destination for deserialized value
+ *  @tparam Stream - Type of datastream buffer
+ *  @return datastream<Stream>& - Reference to the datastream
+ */
+template<typename Stream>
+datastream<Stream>& operator >> ( datastream<Stream>& ds, std::string_view& s ) {
+   unsigned_int v;
+   ds >> v;
+   eosio::check( ds.remaining() >= v.value, "datastream attempted to read past the end" );
+   s = std::string_view(ds.pos(), v.value);
+   ds.skip(v.value);
+   return ds;
+}
+
+// std::span is C++20, contracts built with -std=c++17 don't get these overloads
+#if __cplusplus > 201703L
+/**
+ *  Serialize a span of bytes, in the same format as a std::vector<char>
+ *
+ *  @param ds - The stream to write
+ *  @param s - The value to serialize
+ *  @tparam Stream - Type of datastream buffer
+ *  @tparam Extent - Extent of the span
+ *  @return datastream<Stream>& - Reference to the datastream
+ */
+template<typename Stream, std::size_t Extent>
+datastream<Stream>& operator << ( datastream<Stream>& ds, const std::span<const char, Extent>& s ) {
+   ds << unsigned_int(s.size());
+   if (s.size())
+      ds.write(s.data(), s.size());
+   return ds;
+}
+
+/**
+ *  Deserialize bytes into a span pointing into the buffer of the stream
+ *
+ *  @details No data is copied, the span is only valid as long as the buffer of the stream is
+ *  @param ds - The stream to read
+ *  @param s - The destination for deserialized value
+ *  @tparam Stream - Type of datastream buffer
+ *  @return datastream<Stream>& - Reference to the datastream
+ */
+template<typename Stream>
+datastream<Stream>& operator >> ( datastream<Stream>& ds, std::span<const char>& s ) {
+   unsigned_int v;
+   ds >> v;
+   eosio::check( ds.remaining() >= v.value, "datastream attempted to read past the end" );
+   s = std::span<const char>(ds.pos(), v.value);
+   ds.skip(v.value);
+   return ds;
+}
+#endif
+
 
 /**
  *  Serialize a set
@@ -1095,4 +1174,75 @@ std::vector<char> pack( const T& value ) {
   ds << value;
   return result;
 }
+
+/// @cond INTERNAL
+namespace detail {
+   // Heap buffer for the packs that don't fit on the stack. It is only grown, a contract
+   // runs a single action so the first large packs size it for the rest of the action.
+   struct pack_scratch_buffer {
+      char*  data     = nullptr;
+      size_t capacity = 0;
+      bool   in_use   = false;
+   };
+
+   inline pack_scratch_buffer& get_pack_scratch_buffer() {
+      static pack_scratch_buffer buffer;
+      return buffer;
+   }
+
+   // Call `f` with a buffer of `size` bytes: on the stack if it fits in `StackSize` bytes, otherwise
+   // the scratch buffer. The buffer is only valid until `f` returns.
+   template<size_t StackSize, typename F>
+   decltype(auto) with_scratch_buffer( size_t size, F&& f ) {
+      if (size <= StackSize) {
+         char buffer[StackSize];
+         return f(static_cast<char*>(buffer));
+      }
+
+      auto& scratch = get_pack_scratch_buffer();
+      if (scratch.in_use) {
+         // called from `f` of an outer pack still using the buffer
+         std::vector<char> buffer(size);
+         return f(buffer.data());
+      }
+      if (scratch.capacity < size) {
+         // `free` doesn't reclaim memory with the bump allocator of eosiolib, `realloc` grows the
+         // last allocation in place. Doubling keeps the number of reallocations logarithmic.
+         const size_t capacity = size > scratch.capacity * 2 ? size : scratch.capacity * 2;
+         char* data = static_cast<char*>(realloc(scratch.data, capacity));
+         eosio::check( data != nullptr, "failed to allocate pack buffer" );
+         scratch.data     = data;
+         scratch.capacity = capacity;
+      }
+
+      struct release_scratch {
+         pack_scratch_buffer& buffer;
+         ~release_scratch() { buffer.in_use = false; }
+      } release{scratch};
+      scratch.in_use = true;
+      return f(scratch.data);
+   }
+}
+/// @endcond
+
+/**
+ * Pack data and pass the packed bytes to a function, without allocating a `std::vector` for them
+ *
+ * @details Data with a packed size of at most `StackSize` bytes is packed on the stack, bigger data into a heap
+ * buffer reused across calls. The bytes are only valid until `f` returns.
+ * @ingroup datastream
+ * @tparam StackSize - Largest packed size to pack on the stack
+ * @param value - Data to be packed
+ * @param f - Function called with a `const char*` to the packed bytes and their size
+ * @return The result of `f`
+ */
+template<size_t StackSize = 512, typename T, typename F>
+decltype(auto) with_packed( const T& value, F&& f ) {
+  const size_t size = pack_size(value);
+  return detail::with_scratch_buffer<StackSize>(size, [&](char* buffer) -> decltype(auto) {
+     datastream<char*> ds( buffer, size );
+     ds << value;
+     return f(static_cast<const char*>(buffer), size);
+  });
+}
 }
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace eosio { namespace detail {
+
+   /// @cond INTERNAL
+
+   /**
+    * Minimal perfect hash over a fixed set of 64 bit keys (action names, hash_ids), built at compile time.
+    *
+    * @details Uses hash and displace: the keys are split into buckets by a multiplicative hash and every
+    * bucket is given a seed that places all of its keys into free slots of a table of exactly N entries.
+    * A lookup costs one hash and one compare.
+    * @tparam N - Number of keys
+    */
+   template <std::size_t N>
+   struct perfect_hash {
+      static constexpr uint32_t log2_ceil(std::size_t n) {
+         uint32_t bits = 0;
+         while ((std::size_t(1) << bits) < n)
+            ++bits;
+         return bits;
+      }
+
+      static constexpr uint32_t    bucket_bits  = log2_ceil(N / 2);
+      static constexpr std::size_t bucket_count = std::size_t(1) << bucket_bits;
+
+      static constexpr uint64_t mix(uint64_t k) {
+         k ^= k >> 33;
+         k *= 0xff51afd7ed558ccdull;
+         k ^= k >> 33;
+         k *= 0xc4ceb9fe1a85ec53ull;
+         k ^= k >> 33;
+         return k;
+      }
+
+      static constexpr std::size_t bucket(uint64_t k) {
+         if constexpr (bucket_bits == 0)
+            return 0;
+         else
+            return (k * 0x9e3779b97f4a7c15ull) >> (64 - bucket_bits);
+      }
+
+      static constexpr std::size_t slot(uint64_t k, uint64_t seed) { return mix(k ^ seed) % N; }
+
+      /**
+       * Find the position of a key in the array the table was built from
+       *
+       * @param k - The key to look up
+       * @return int32_t - The position of the key, -1 if it is not in the table
+       */
+      constexpr int32_t find(uint64_t k)const {
+         const std::size_t s = slot(k, seeds[bucket(k)]);
+         return keys[s] == k ? static_cast<int32_t>(index[s]) : -1;
+      }
+
+      uint64_t keys[N] = {};
+      uint32_t index[N] = {};
+      uint64_t seeds[bucket_count] = {};
+      bool     valid          = false; // false if the table couldn't be built, see the flags below
+      bool     duplicate_keys = false; // the keys are not unique
+      bool     seed_not_found = false; // no seed places the keys of some bucket into free slots
+   };
+
+   template <>
+   struct perfect_hash<0> {
+      constexpr int32_t find(uint64_t)const { return -1; }
+      bool valid          = true;
+      bool duplicate_keys = false;
+      bool seed_not_found = false;
+   };
+
+   /**
+    * Build a minimal perfect hash table over `keys` at compile time
+    *
+    * @details The returned table has `valid` set to false if it couldn't be built, with
+    * `duplicate_keys` set if the keys are not unique or `seed_not_found` set if the search for
+    * the seed of a bucket gave up. Callers are expected to `static_assert` on both flags.
+    * @param keys - The keys
+    * @param max_seed - The seeds tried for each bucket are below it
+    * @return perfect_hash<N> - The table
+    */
+   template <std::size_t N>
+   constexpr perfect_hash<N> make_perfect_hash(const uint64_t (&keys)[N], uint64_t max_seed = uint64_t(1) << 16) {
+      using table_t = perfect_hash<N>;
+      table_t table{};
+
+      for (std::size_t i = 0; i < N; ++i)
+         for (std::size_t j = i + 1; j < N; ++j)
+            if (keys[i] == keys[j]) {
+               table.duplicate_keys = true;
+               return table;
+            }
+
+      // place the biggest buckets first, while most of the slots are free
+      std::size_t bucket_size[table_t::bucket_count] = {};
+      std::size_t order[table_t::bucket_count] = {};
+      for (std::size_t i = 0; i < N; ++i)
+         ++bucket_size[table_t::bucket(keys[i])];
+      for (std::size_t b = 0; b < table_t::bucket_count; ++b) {
+         std::size_t j = b;
+         for (; j > 0 && bucket_size[order[j-1]] < bucket_size[b]; --j)
+            order[j] = order[j-1];
+         order[j] = b;
+      }
+
+      bool used[N] = {};
+      std::size_t members[N] = {};
+      std::size_t slots[N] = {};
+      for (std::size_t b : order) {
+         std::size_t count = 0;
+         for (std::size_t i = 0; i < N; ++i)
+            if (table_t::bucket(keys[i]) == b)
+               members[count++] = i;
+         if (count == 0)
+            break;
+
+         uint64_t seed = 1;
+         for (; seed < max_seed; ++seed) {
+            bool fits = true;
+            for (std::size_t m = 0; m < count && fits; ++m) {
+               slots[m] = table_t::slot(keys[members[m]], seed);
+               fits = !used[slots[m]];
+               for (std::size_t p = 0; p < m && fits; ++p)
+                  fits = slots[p] != slots[m];
+            }
+            if (fits)
+               break;
+         }
+         if (seed >= max_seed) {
+            table.seed_not_found = true;
+            return table;
+         }
+
+         table.seeds[b] = seed;
+         for (std::size_t m = 0; m < count; ++m) {
+            used[slots[m]] = true;
+            table.keys[slots[m]]  = keys[members[m]];
+            table.index[slots[m]] = static_cast<uint32_t>(members[m]);
+         }
+      }
+      table.valid = true;
+      return table;
+   }
+
+   /// @endcond
+}} // ns eosio::detail
@@ -1,4 +1,5 @@
 #include <memory>
+#include <cstdint>
 #include "core/eosio/check.hpp"
 
 #ifdef EOSIO_NATIVE
@@ -29,6 +30,7 @@ namespace eosio {
          volatile uintptr_t heap_base = 0; // linker places this at address 0
          heap = align(*(char**)heap_base, 16);
          last_ptr = heap;
+         last_alloc = nullptr;
 
          next_page = CURRENT_MEMORY;
       }
@@ -39,6 +41,7 @@ namespace eosio {
 
          char* ret = last_ptr;
          last_ptr = align(last_ptr+sz, align_amt);
+         last_alloc = ret;
 
          size_t pages_to_alloc = sz >> 16;
          next_page += pages_to_alloc;
@@ -50,8 +53,28 @@ namespace eosio {
          return ret;
       }
 
+      // resize the most recent allocation in place by moving the top of the heap,
+      // returns false if `ptr` is not the last block handed out
+      bool resize(char* ptr, size_t sz, uint8_t align_amt=16) {
+         if (ptr == nullptr || ptr != last_alloc || sz == 0)
+            return false;
+         // the new top of the heap would wrap around the address space
+         if (sz > SIZE_MAX - (size_t)ptr - align_amt)
+            return false;
+
+         last_ptr = align(ptr+sz, align_amt);
+
+         size_t pages_needed = ((size_t)last_ptr >> 16) + 1;
+         if (pages_needed > next_page) {
+            eosio::check(GROW_MEMORY(pages_needed - next_page) != -1, "failed to allocate pages");
+            next_page = pages_needed;
+         }
+         return true;
+      }
+
       char*  heap;
       char*  last_ptr;
+      char*  last_alloc;
       size_t offset;
       size_t next_page;
    };
@@ -75,6 +98,9 @@ void* calloc(size_t count, size_t size) {
 }
 
 void* realloc(void* ptr, size_t size) {
+   // growing (or shrinking) the block at the top of the heap needs no copy
+   if (eosio::_dsmalloc.resize((char*)ptr, size))
+      return ptr;
    if (void* result = eosio::_dsmalloc(size)) {
       // May read out of bounds, but that's okay, as the
       // contents of the memory are undefined anyway.
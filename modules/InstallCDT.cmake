@@ -67,6 +67,7 @@ cdt_clang_install(clang-9)
 cdt_clang_install(wasm-ld)
 
 cdt_tool_install_and_symlink(eosio-pp cdt-pp)
+cdt_tool_install_and_symlink(eosio-stack-usage cdt-stack-usage)
 cdt_tool_install_and_symlink(eosio-wast2wasm cdt-wast2wasm)
 cdt_tool_install_and_symlink(eosio-wasm2wast cdt-wasm2wast)
 cdt_tool_install_and_symlink(cdt-cc cdt-cc)
@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+"""
+Tests of cdt-abidiff: the text and -json reports, -batch and the failures, run against base.abi
+and copies of it changed by each case.
+
+Usage: abidiff_tests.py <path of cdt-abidiff>
+"""
+import copy
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import unittest
+from typing import Dict, List
+
+ABIDIFF: str = ""
+BASE_ABI: str = os.path.join(os.path.dirname(os.path.abspath(__file__)), "base.abi")
+
+
+class AbidiffTests(unittest.TestCase):
+    def setUp(self):
+        self.work_dir = tempfile.TemporaryDirectory()
+        with open(BASE_ABI) as f:
+            self.base = json.load(f)
+
+    def tearDown(self):
+        self.work_dir.cleanup()
+
+    def write_abi(self, name: str, abi: Dict) -> str:
+        path = os.path.join(self.work_dir.name, name)
+        with open(path, "w") as f:
+            json.dump(abi, f, indent=4)
+        return path
+
+    def changed(self, name: str, section: str, key: str, key_value: str, **fields) -> str:
+        """Writes a copy of base.abi with `fields` of the entry of `section` whose `key` is `key_value` changed."""
+        abi = copy.deepcopy(self.base)
+        entry = next(e for e in abi[section] if e[key] == key_value)
+        entry.update(fields)
+        return self.write_abi(name, abi)
+
+    def abidiff(self, *args: str) -> subprocess.CompletedProcess:
+        return subprocess.run([ABIDIFF, *args], capture_output=True, text=True)
+
+    def diff_json(self, abi1: str, abi2: str) -> Dict:
+        res = self.abidiff("-json", abi1, abi2)
+        self.assertEqual(res.returncode, 0, res.stderr)
+        return json.loads(res.stdout)
+
+    def assert_no_differences(self, abi1: str, abi2: str):
+        res = self.abidiff(abi1, abi2)
+        self.assertEqual(res.returncode, 0, res.stderr)
+        self.assertEqual(res.stdout, "")
+        result = self.diff_json(abi1, abi2)
+        self.assertEqual(result["removed"], {})
+        self.assertEqual(result["added"], {})
+
+    def test_identical(self):
+        # the copy has the struct without fields, which the old loops always reported as different
+        self.assert_no_differences(BASE_ABI, self.write_abi("copy.abi", self.base))
+
+    def test_json(self):
+        changed = self.changed("changed.abi", "actions", "name", "hi", type="noargs")
+        result = self.diff_json(BASE_ABI, changed)
+        self.assertEqual(result["abi1"], os.path.realpath(BASE_ABI))
+        self.assertEqual(result["abi2"], os.path.realpath(changed))
+        self.assertEqual(result["removed"], {"actions": [{"name": "hi", "type": "hi", "ricardian_contract": ""}]})
+        self.assertEqual(result["added"], {"actions": [{"name": "hi", "type": "noargs", "ricardian_contract": ""}]})
+
+    def test_text(self):
+        changed = self.changed("changed.abi", "tables", "name", "greetings", type="hi")
+        res = self.abidiff(BASE_ABI, changed)
+        self.assertEqual(res.returncode, 0, res.stderr)
+        lines = res.stdout.splitlines()
+        self.assertEqual([l for l in lines if l[:1] in "<>"], ["< table", "> table"])
+        self.assertIn('"type": "greeting"', res.stdout)
+        self.assertIn('"type": "hi"', res.stdout)
+
+    def test_removed_and_added_entries(self):
+        abi = copy.deepcopy(self.base)
+        abi["types"] = []
+        abi["structs"].append({"name": "bye", "base": "", "fields": []})
+        result = self.diff_json(BASE_ABI, self.write_abi("changed.abi", abi))
+        self.assertEqual(result["removed"], {"types": self.base["types"]})
+        self.assertEqual(result["added"], {"structs": [{"name": "bye", "base": "", "fields": []}]})
+
+    def test_struct_without_fields(self):
+        changed = self.changed("changed.abi", "structs", "name", "noargs", base="hi")
+        result = self.diff_json(BASE_ABI, changed)
+        self.assertEqual(result["removed"], {"structs": [{"name": "noargs", "base": "", "fields": []}]})
+        self.assertEqual(result["added"], {"structs": [{"name": "noargs", "base": "hi", "fields": []}]})
+
+    def test_variant_types_of_different_lengths(self):
+        # the old loop read the types of the shorter list past its end
+        shorter = self.changed("shorter.abi", "variants", "name", "variant_name_string", types=["name"])
+        for abi1, abi2 in [(BASE_ABI, shorter), (shorter, BASE_ABI)]:
+            result = self.diff_json(abi1, abi2)
+            self.assertEqual(len(result["removed"]["variants"]), 1)
+            self.assertEqual(len(result["added"]["variants"]), 1)
+        result = self.diff_json(BASE_ABI, shorter)
+        self.assertEqual(result["removed"]["variants"][0]["types"], ["name", "string"])
+        self.assertEqual(result["added"]["variants"][0]["types"], ["name"])
+
+    def test_action_results(self):
+        # the old loop compared the action results of the first ABI with the wrong entry of the second
+        abi = copy.deepcopy(self.base)
+        abi["action_results"].reverse()
+        self.assert_no_differences(BASE_ABI, self.write_abi("reordered.abi", abi))
+
+        changed = self.changed("changed.abi", "action_results", "name", "noargs", result_type="uint32")
+        result = self.diff_json(BASE_ABI, changed)
+        self.assertEqual(result["removed"], {"action_results": [{"name": "noargs", "result_type": "uint64"}]})
+        self.assertEqual(result["added"], {"action_results": [{"name": "noargs", "result_type": "uint32"}]})
+
+    def test_ricardian_clauses(self):
+        # the old loop printed the clauses from a `clauses` section, which ABIs don't have
+        changed = self.changed("changed.abi", "ricardian_clauses", "id", "Data Usage", body="Greetings are private.")
+        res = self.abidiff(BASE_ABI, changed)
+        self.assertEqual(res.returncode, 0, res.stderr)
+        self.assertEqual([l for l in res.stdout.splitlines() if l[:1] in "<>"], ["< clause", "> clause"])
+        self.assertIn("Greetings are public.", res.stdout)
+        self.assertIn("Greetings are private.", res.stdout)
+        self.assertNotIn("Data Storage", res.stdout)
+
+    def test_missing_file(self):
+        missing = os.path.join(self.work_dir.name, "missing.abi")
+        for args in [(BASE_ABI, missing), (missing, BASE_ABI), ("-json", BASE_ABI, missing)]:
+            res = self.abidiff(*args)
+            self.assertNotEqual(res.returncode, 0)
+            self.assertIn(missing, res.stderr)
+
+    def test_usage_errors(self):
+        batch = self.write_batch("batch.txt", [f"{BASE_ABI} {BASE_ABI}"])
+        for args in [(BASE_ABI,), (BASE_ABI, BASE_ABI, BASE_ABI), ("-batch", batch, BASE_ABI, BASE_ABI)]:
+            self.assertNotEqual(self.abidiff(*args).returncode, 0, args)
+
+    def write_batch(self, name: str, lines: List[str]) -> str:
+        path = os.path.join(self.work_dir.name, name)
+        with open(path, "w") as f:
+            f.write("\n".join(lines) + "\n")
+        return path
+
+    def test_batch(self):
+        shorter = self.changed("shorter.abi", "variants", "name", "variant_name_string", types=["name"])
+        changed = self.changed("changed.abi", "actions", "name", "hi", type="noargs")
+        pairs = [(BASE_ABI, shorter), (BASE_ABI, BASE_ABI), (changed, BASE_ABI)] * 4
+        batch = self.write_batch("batch.txt", [f"{a} {b}" for a, b in pairs] + [""])
+
+        for jobs in ["-j1", "-j4"]:
+            res = self.abidiff("-batch", batch, jobs, "-json")
+            self.assertEqual(res.returncode, 0, res.stderr)
+            results = json.loads(res.stdout)
+            # in the order of the batch file, whatever thread diffed them
+            self.assertEqual([(r["abi1"], r["abi2"]) for r in results],
+                             [(os.path.realpath(a), os.path.realpath(b)) for a, b in pairs])
+            for r, (a, b) in zip(results, pairs):
+                self.assertEqual(r, self.diff_json(a, b))
+
+            res = self.abidiff("-batch", batch, jobs)
+            self.assertEqual(res.returncode, 0, res.stderr)
+            headers = [l for l in res.stdout.splitlines() if l.startswith("--- ")]
+            self.assertEqual(headers, [f"--- {os.path.realpath(a)} +++ {os.path.realpath(b)}" for a, b in pairs])
+
+    def test_batch_errors(self):
+        missing = os.path.join(self.work_dir.name, "missing.abi")
+        batch = self.write_batch("batch.txt", [f"{BASE_ABI} {missing}", f"{BASE_ABI} {BASE_ABI}"])
+        res = self.abidiff("-batch", batch, "-json")
+        self.assertNotEqual(res.returncode, 0)
+        self.assertIn(missing, res.stderr)
+        results = json.loads(res.stdout)
+        self.assertEqual(len(results), 2)
+        self.assertIn("error", results[0])
+        self.assertEqual(results[1]["removed"], {})
+
+        # the pairs after a failed one are still diffed
+        res = self.abidiff("-batch", batch)
+        self.assertNotEqual(res.returncode, 0)
+        self.assertIn(f"--- {os.path.realpath(BASE_ABI)} +++ {os.path.realpath(BASE_ABI)}", res.stdout)
+
+        odd = self.write_batch("odd.txt", [BASE_ABI])
+        self.assertNotEqual(self.abidiff("-batch", odd).returncode, 0)
+        self.assertNotEqual(self.abidiff("-batch", missing).returncode, 0)
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        sys.exit(__doc__)
+    ABIDIFF = sys.argv.pop(1)
+    unittest.main()
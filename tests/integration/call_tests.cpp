@@ -126,6 +126,19 @@ BOOST_AUTO_TEST_CASE(void_func_test) { try {
    check(trx_trace);
 } FC_LOG_AND_RETHROW() }
 
+// Verify a batch of calls is executed in order in a single sync call
+BOOST_AUTO_TEST_CASE(batch_call_test) { try {
+   call_tester t({
+      {"caller"_n, contracts::caller_wasm(), contracts::caller_abi().data()},
+      {"callee"_n, contracts::callee_wasm(), contracts::callee_abi().data()}
+   });
+
+   auto trx_trace = t.push_action("caller"_n, "wrpbatchtst"_n, "caller"_n, {});
+   auto& call_traces = trx_trace->action_traces[0].call_traces;
+   BOOST_REQUIRE_EQUAL(call_traces.size(), 1u);
+   BOOST_REQUIRE_EQUAL(call_traces[0].console, "I am a void function");
+} FC_LOG_AND_RETHROW() }
+
 // Verify a function tagged as both `action` and `call` works
 BOOST_AUTO_TEST_CASE(mixed_action_call_tags_test) { try {
    call_tester t({
@@ -25,6 +25,10 @@ BOOST_FIXTURE_TEST_CASE( malloc_tests, tester ) try {
 
    push_action("test"_n, "mallocpass"_n, "test"_n, {});
    push_action("test"_n, "mallocalign"_n, "test"_n, {});
+   push_action("test"_n, "reallocpass"_n, "test"_n, {});
+   BOOST_CHECK_EXCEPTION( push_action("test"_n, "reallocfail"_n, "test"_n, {}),
+                          eosio_assert_message_exception,
+                          eosio_assert_message_is("failed to allocate pages") );
    BOOST_CHECK_EXCEPTION( push_action("test"_n, "mallocfail"_n, "test"_n, {}),
                           eosio_assert_message_exception,
                           eosio_assert_message_is("failed to allocate pages") );
@@ -0,0 +1,24 @@
+#include <eosio/call.hpp>
+#include <eosio/eosio.hpp>
+
+// codegen and abigen must both see through the aliases: `nothing` is no return value and the
+// contract derives from `eosio::contract`
+using nothing = void;
+using base_contract = eosio::contract;
+
+class [[eosio::contract]] void_typedef_result : public base_contract {
+public:
+   using base_contract::base_contract;
+
+   [[eosio::action]]
+   nothing act() {}
+
+   [[eosio::action]]
+   uint32_t actvalue() { return 1; }
+
+   [[eosio::call]]
+   nothing callnothing() {}
+
+   [[eosio::call]]
+   uint32_t callvalue() { return 1; }
+};
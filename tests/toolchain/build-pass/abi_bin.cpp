@@ -0,0 +1,30 @@
+// Builds with -abi-bin, abi_bin.py checks the .abi.bin decodes to the .abi, also when the ABI
+// is merged from sources seeing different parts of the contract.
+#include <eosio/eosio.hpp>
+
+using namespace eosio;
+
+class [[eosio::contract]] abi_bin : public eosio::contract {
+   public:
+      using contract::contract;
+
+      [[eosio::action]] void hi(name user) { print("Hello, ", user); }
+
+      [[eosio::action]] uint64_t count() { return 1; }
+
+      struct [[eosio::table]] greeting {
+         name     user;
+         uint64_t count;
+         uint64_t primary_key() const { return user.value; }
+      };
+      using greetings = multi_index<"greetings"_n, greeting>;
+};
+
+#ifdef ABI_BIN_EXTRA
+class [[eosio::contract("abi_bin")]] abi_bin_extra : public eosio::contract {
+   public:
+      using contract::contract;
+
+      [[eosio::action]] void bye(std::variant<name, std::string> user) {}
+};
+#endif
@@ -0,0 +1,101 @@
+# -abi-bin: the .abi.bin decodes to the same ABI as the .abi written by the link, also when the
+# ABI is merged from the objects of sources compiled in parallel.
+import json
+import struct
+
+from checklib import check, copy_source, fail, run
+
+NAME_CHARS = ".12345abcdefghijklmnopqrstuvwxyz"
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def bytes(self, n):
+        if self.pos + n > len(self.data):
+            fail("the .abi.bin is truncated")
+        b = self.data[self.pos:self.pos + n]
+        self.pos += n
+        return b
+
+    def varuint(self):
+        value, shift = 0, 0
+        while True:
+            b = self.bytes(1)[0]
+            value |= (b & 0x7f) << shift
+            shift += 7
+            if not b & 0x80:
+                return value
+
+    def uint64(self):
+        return struct.unpack("<Q", self.bytes(8))[0]
+
+    def string(self):
+        return self.bytes(self.varuint()).decode("utf-8")
+
+    def name(self):
+        value = self.uint64()
+        chars = []
+        for i in range(13):
+            mask, shift = (0x0f, 4) if i == 0 else (0x1f, 5)
+            chars.append(NAME_CHARS[value & mask])
+            value >>= shift
+        return "".join(reversed(chars)).rstrip(".")
+
+    def array(self, read):
+        return [read() for _ in range(self.varuint())]
+
+    def at_end(self):
+        return self.pos == len(self.data)
+
+
+def decode(data):
+    """Decodes an abi_def in the field order of eosio libraries/chain/include/eosio/chain/abi_def.hpp."""
+    r = Reader(data)
+    abi = {"version": r.string()}
+    abi["types"] = r.array(lambda: {"new_type_name": r.string(), "type": r.string()})
+    abi["structs"] = r.array(lambda: {"name": r.string(), "base": r.string(),
+                                      "fields": r.array(lambda: {"name": r.string(), "type": r.string()})})
+    abi["actions"] = r.array(lambda: {"name": r.name(), "type": r.string(), "ricardian_contract": r.string()})
+    abi["tables"] = r.array(lambda: {"name": r.name(), "index_type": r.string(), "key_names": r.array(r.string),
+                                     "key_types": r.array(r.string), "type": r.string()})
+    abi["ricardian_clauses"] = r.array(lambda: {"id": r.string(), "body": r.string()})
+    abi["error_messages"] = r.array(lambda: {"error_code": r.uint64(), "error_msg": r.string()})
+    check(r.varuint() == 0, "the .abi.bin has ABI extensions")
+    abi["variants"] = r.array(lambda: {"name": r.string(), "types": r.array(r.string)})
+    abi["action_results"] = r.array(lambda: {"name": r.name(), "result_type": r.string()})
+    if not r.at_end():
+        abi["calls"] = r.array(lambda: {"name": r.string(), "type": r.string(), "id": r.uint64(),
+                                        "result_type": r.string()})
+    check(r.at_end(), "the .abi.bin has trailing data")
+    return abi
+
+
+def check_abi_bin(output):
+    with open(output.replace(".wasm", ".abi")) as f:
+        expected = json.load(f)
+    with open(output.replace(".wasm", ".abi.bin"), "rb") as f:
+        decoded = decode(f.read())
+    for section, value in decoded.items():
+        if section in expected:
+            check(value == expected[section], f"the {section} of {output} differ between the .abi and the .abi.bin")
+        else:
+            check(not value, f"the .abi.bin of {output} has {section} the .abi doesn't have")
+    return decoded
+
+
+source = copy_source()
+run("cdt-cpp", "-abi-bin", "--contract=abi_bin", source, "-o", "abi_bin.wasm")
+abi = check_abi_bin("abi_bin.wasm")
+check({a["name"] for a in abi["actions"]} == {"hi", "count"}, "unexpected actions in the .abi.bin")
+check({t["name"] for t in abi["tables"]} == {"greetings"}, "unexpected tables in the .abi.bin")
+check({a["name"] for a in abi["action_results"]} == {"count"}, "unexpected action results in the .abi.bin")
+
+with open("extra.cpp", "w") as f:
+    f.write(f'#define ABI_BIN_EXTRA\n#include "{source}"\n')
+run("cdt-cpp", "-abi-bin", "-j2", "--contract=abi_bin", source, "extra.cpp", "-o", "merged.wasm")
+abi = check_abi_bin("merged.wasm")
+check({a["name"] for a in abi["actions"]} == {"hi", "count", "bye"}, "the .abi.bin wasn't written from the merged ABI")
+check(len(abi["variants"]) == 1, "the .abi.bin is missing the variant of the extra source")
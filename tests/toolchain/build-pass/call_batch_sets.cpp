@@ -0,0 +1,22 @@
+// call_batch_sets.py links it with a source defining call_batch_extra too: the batch dispatcher
+// generated by cdt-ld knows the calls of both objects.
+#include <eosio/call.hpp>
+#include <eosio/eosio.hpp>
+
+using namespace eosio;
+
+class [[eosio::contract]] call_batch_sets : public eosio::contract {
+   public:
+      using contract::contract;
+
+      [[eosio::call]] uint32_t get() { return 1; }
+};
+
+#ifdef EXTRA_CALLS
+class [[eosio::contract("call_batch_sets")]] call_batch_extra : public eosio::contract {
+   public:
+      using contract::contract;
+
+      [[eosio::call]] uint32_t put(uint32_t value) { return value; }
+};
+#endif
@@ -0,0 +1,23 @@
+# The batch dispatcher is generated at link time from the entries of every object: objects declaring
+# different sync calls link in any order, and the table of the dispatcher has the hash_ids of all of them.
+import struct
+
+from checklib import check, copy_source, run
+
+
+def hash_id(name: str) -> int:
+    h = 5381
+    for c in name.encode():
+        h = (h * 33 + c) % 2**64
+    return h
+
+
+source = copy_source()
+with open("extra.cpp", "w") as f:
+    f.write(f'#define EXTRA_CALLS\n#include "{source}"\n')
+
+table = struct.pack("<2Q", *sorted([hash_id("get"), hash_id("put")]))
+for inputs in [(source, "extra.cpp"), ("extra.cpp", source)]:
+    run("cdt-cpp", "--contract=call_batch_sets", *inputs, "-o", "extra.wasm")
+    with open("extra.wasm", "rb") as f:
+        check(table in f.read(), f"the batch dispatcher of {' '.join(inputs)} doesn't know every sync call")
@@ -0,0 +1,18 @@
+// Builds with -fcdt-cache, cdt_cache.py checks rebuilds are cache hits until the source changes.
+#include <eosio/eosio.hpp>
+
+using namespace eosio;
+
+class [[eosio::contract]] cdt_cache : public eosio::contract {
+   public:
+      using contract::contract;
+
+      [[eosio::action]] void hi(name user) { print("Hello, ", user); }
+
+      struct [[eosio::table]] greeting {
+         name     user;
+         uint64_t count;
+         uint64_t primary_key() const { return user.value; }
+      };
+      using greetings = multi_index<"greetings"_n, greeting>;
+};
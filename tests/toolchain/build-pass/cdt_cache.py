@@ -0,0 +1,52 @@
+# -fcdt-cache: a second build of an unchanged contract is a hit in the build cache, it neither
+# compiles nor links and restores the same .wasm and .abi. Editing the source invalidates it.
+import filecmp
+import json
+
+from checklib import check, copy_source, run, time_report_events
+
+
+def build(source, output):
+    run("cdt-cpp", "-fcdt-cache", "-cdt-cache-dir=cache", "--contract=cdt_cache", f"-time-report={output}.json",
+        source, "-o", output)
+    events = time_report_events(f"{output}.json")
+    compiled = any(e["name"] == "clang-9" and "-E" not in e["args"]["detail"].split() for e in events)
+    linked = any(e["name"] == "wasm-ld" for e in events)
+    return compiled, linked
+
+
+def abi_actions(abi_file):
+    with open(abi_file) as f:
+        return {action["name"] for action in json.load(f)["actions"]}
+
+
+source = copy_source()
+
+compiled, linked = build(source, "first.wasm")
+check(compiled and linked, "the first build was a cache hit")
+check(abi_actions("first.abi") == {"hi"}, "the first build wrote an unexpected ABI")
+with open("first.abi") as f:
+    first_abi = f.read()
+
+# the .abi is restored from the cache, not left over from the previous build
+with open("first.abi", "w") as f:
+    f.write("stale")
+run("cdt-cpp", "-fcdt-cache", "-cdt-cache-dir=cache", "--contract=cdt_cache", source, "-o", "first.wasm")
+with open("first.abi") as f:
+    check(f.read() == first_abi, "a cache hit left a stale .abi")
+
+compiled, linked = build(source, "second.wasm")
+check(not compiled, "the second build compiled the unchanged source")
+check(not linked, "the second build linked the unchanged objects")
+check(filecmp.cmp("first.wasm", "second.wasm", shallow=False), "the cached .wasm differs")
+check(filecmp.cmp("first.abi", "second.abi", shallow=False), "the cached .abi differs")
+
+with open(source) as f:
+    text = f.read()
+with open(source, "w") as f:
+    f.write(text.replace("[[eosio::action]] void hi(name user)",
+                         "[[eosio::action]] void bye(name user) { print(\"Bye, \", user); }\n"
+                         "      [[eosio::action]] void hi(name user)"))
+compiled, linked = build(source, "third.wasm")
+check(compiled and linked, "the edited source was a cache hit")
+check(abi_actions("third.abi") == {"bye", "hi"}, "the build of the edited source wrote a stale ABI")
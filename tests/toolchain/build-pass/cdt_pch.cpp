@@ -0,0 +1,19 @@
+// Builds with -fcdt-pch, cdt_pch.py checks the precompiled header is built once and reused.
+// The comment before the include doesn't prevent its use.
+#include <eosio/eosio.hpp>
+
+using namespace eosio;
+
+class [[eosio::contract]] cdt_pch : public eosio::contract {
+   public:
+      using contract::contract;
+
+      [[eosio::action]] void hi(name user) { print("Hello, ", user); }
+
+      struct [[eosio::table]] greeting {
+         name     user;
+         uint64_t count;
+         uint64_t primary_key() const { return user.value; }
+      };
+      using greetings = multi_index<"greetings"_n, greeting>;
+};
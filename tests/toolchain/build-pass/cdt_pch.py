@@ -0,0 +1,38 @@
+# -fcdt-pch builds the precompiled header once, later compiles reuse it. A source whose first
+# directive is not the include of <eosio/eosio.hpp> is compiled without it.
+import glob
+import os
+
+from checklib import check, copy_source, run, time_report_events
+
+
+def compile_with_pch(source, output):
+    run("cdt-cpp", "-fcdt-pch", "-pch-dir=pch", "--contract=cdt_pch", f"-time-report={output}.json",
+        "-c", source, "-o", output)
+    clang = [e["args"]["detail"] for e in time_report_events(f"{output}.json") if e["name"] == "clang-9"]
+    built = any("-xc++-header" in detail for detail in clang)
+    used = any("-include-pch" in detail and output in detail.split() for detail in clang)
+    return built, used
+
+
+source = copy_source()
+
+built, used = compile_with_pch(source, "first.o")
+check(built, "the first compile didn't build the precompiled header")
+check(used, "the first compile didn't use the precompiled header")
+pch_files = glob.glob("pch/*.pch")
+check(len(pch_files) == 1, f"expected one precompiled header, found {pch_files}")
+mtime = os.path.getmtime(pch_files[0])
+
+built, used = compile_with_pch(source, "second.o")
+check(not built, "the second compile rebuilt the precompiled header")
+check(used, "the second compile didn't use the precompiled header")
+check(glob.glob("pch/*.pch") == pch_files and os.path.getmtime(pch_files[0]) == mtime,
+      "the second compile replaced the precompiled header")
+
+with open(source) as f:
+    text = f.read()
+with open("defines_first.cpp", "w") as f:
+    f.write("#define EOSIO_CDT_PCH_TEST 1\n" + text)
+built, used = compile_with_pch("defines_first.cpp", "defines_first.o")
+check(not used, "the precompiled header was used for a source with a directive before its include")
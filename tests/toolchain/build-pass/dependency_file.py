@@ -0,0 +1,57 @@
+# -MD and -MMD for `-c -o`: the dependency file names the contract source instead of the generated one
+# and lists the ricardian files abigen read. The generated source never overwrites an input.
+import os
+
+from checklib import check, copy_source, run
+
+CONTRACTS_MD = """<h1 class="contract">hi</h1>
+---
+spec-version: 0.0.2
+title: hi
+summary: Greets a user.
+icon:
+---
+
+Prints a greeting.
+"""
+
+
+def dependencies(deps_file, target):
+    with open(deps_file) as f:
+        rule = f.read().replace("\\\n", " ")
+    check(rule.startswith(f"{target}:"), f"{deps_file} is not a rule for {target}:\n{rule}")
+    return {os.path.normpath(dep) for dep in rule[len(target) + 1:].split()}
+
+
+source = copy_source()
+with open("dependency_file.contracts.md", "w") as f:
+    f.write(CONTRACTS_MD)
+
+run("cdt-cpp", "-c", "-MD", "--contract=dependency_file", source, "-o", "dependency_file.o")
+deps = dependencies("dependency_file.d", "dependency_file.o")
+check(source in deps, f"the source is missing from the dependency file: {deps}")
+check("dependency_file.contracts.md" in deps, f"the ricardian contracts are missing from the dependency file: {deps}")
+check(not any(dep.endswith(".cdtgen.cpp") for dep in deps), f"the dependency file lists the generated source: {deps}")
+check(any(dep.endswith("eosio.hpp") for dep in deps), f"the headers are missing from the dependency file: {deps}")
+check(not os.path.exists("dependency_file.o.cdtgen.cpp"), "the generated source was left behind")
+
+run("cdt-cpp", "-c", "-MMD", "-MF", "custom.d", "--contract=dependency_file", source, "-o", "mmd.o")
+deps = dependencies("custom.d", "mmd.o")
+check(source in deps and "dependency_file.contracts.md" in deps, f"-MMD -MF wrote the wrong dependencies: {deps}")
+
+# the source named like the generated file of another output used to be overwritten, then removed
+with open(source) as f:
+    text = f.read()
+with open("clash.gen.cpp", "w") as f:
+    f.write(text)
+run("cdt-cpp", "-c", "--contract=dependency_file", "clash.gen.cpp", "-o", "clash.o")
+with open("clash.gen.cpp") as f:
+    check(f.read() == text, "compiling clash.gen.cpp to clash.o changed the source")
+
+with open("clash.o.cdtgen.cpp", "w") as f:
+    f.write(text)
+res = run("cdt-cpp", "-c", "--contract=dependency_file", "clash.o.cdtgen.cpp", "-o", "clash.o", expect_success=False)
+check(res.returncode != 0, "the generated source of clash.o can't be written over its input")
+check("would overwrite the input" in res.stderr.decode("utf-8"), f"unexpected error:\n{res.stderr.decode('utf-8')}")
+with open("clash.o.cdtgen.cpp") as f:
+    check(f.read() == text, "the input named like the generated source was overwritten")
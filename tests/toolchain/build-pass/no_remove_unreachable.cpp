@@ -0,0 +1,10 @@
+#include <eosio/eosio.hpp>
+
+using namespace eosio;
+
+class [[eosio::contract]] no_remove_unreachable : public eosio::contract {
+   public:
+      using contract::contract;
+
+      [[eosio::action]] void hi(name user) { print("Hello, ", user); }
+};
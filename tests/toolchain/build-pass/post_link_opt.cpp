@@ -0,0 +1,16 @@
+#include <eosio/eosio.hpp>
+
+using namespace eosio;
+
+class [[eosio::contract]] post_link_opt : public eosio::contract {
+   public:
+      using contract::contract;
+
+      [[eosio::action]] void test1(name n) { check(n == "eosio"_n, "unexpected name"); }
+      [[eosio::action]] void test2(uint64_t a, uint64_t b) {
+         uint64_t sum = 0;
+         for (uint64_t i = a; i < b; ++i)
+            sum += i;
+         print(sum);
+      }
+};
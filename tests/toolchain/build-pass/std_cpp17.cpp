@@ -0,0 +1,11 @@
+#include <eosio/eosio.hpp>
+
+using namespace eosio;
+
+// the core headers still build as C++17, without the std::span overloads
+class [[eosio::contract]] std_cpp17 : public eosio::contract {
+   public:
+      using contract::contract;
+
+      [[eosio::action]] void hi(name user, std::string memo) { print("Hello, ", user, " ", memo); }
+};
@@ -0,0 +1,14 @@
+#include <eosio/eosio.hpp>
+
+using namespace eosio;
+
+class [[eosio::contract]] time_report : public contract {
+   public:
+      using contract::contract;
+
+#ifdef TIME_REPORT_SECOND
+      [[eosio::action]] void bye(name user) { print("Bye, ", user); }
+#else
+      [[eosio::action]] void hi(name user) { print("Hello, ", user); }
+#endif
+};
@@ -0,0 +1,35 @@
+# -time-report with -j2: the compiles of both sources run in nested cdt-cpp processes and the link
+# in cdt-ld, they all append to the report the top-level cdt-cpp started, which is valid JSON at the end.
+from checklib import check, copy_source, run, time_report_events
+
+source = copy_source()
+with open("second.cpp", "w") as f:
+    f.write(f'#define TIME_REPORT_SECOND\n#include "{source}"\n')
+run("cdt-cpp", "-j2", "-time-report=report.json", "--contract=time_report", source, "second.cpp", "-o", "time_report.wasm")
+
+events = time_report_events("report.json")
+check(isinstance(events, list) and events, "the time report has no events")
+for e in events:
+    check(e.get("ph") == "X" and all(k in e for k in ("name", "cat", "ts", "dur", "pid", "tid")),
+          f"malformed event {e}")
+    check(e["dur"] >= 0, f"negative duration in {e}")
+    check("peak_rss_kb" in e.get("args", {}) and "detail" in e.get("args", {}), f"event {e} lacks its args")
+
+tools = [e for e in events if e["cat"] == "tool"]
+# the top-level cdt-cpp is the one running the parallel compiles
+top_level = [e["pid"] for e in events if e["name"] == "cdt-cpp" and e["cat"] == "subprocess" and e["args"]["detail"] == "2 jobs"]
+check(len(top_level) == 1, f"expected one top-level cdt-cpp running 2 jobs: {tools}")
+top_pid = top_level[0]
+check(any(e["name"] == "cdt-cpp" and e["pid"] == top_pid for e in tools), "the top-level cdt-cpp wrote no tool event")
+
+nested_compiles = {e["pid"] for e in tools if e["name"] == "cdt-cpp" and e["pid"] != top_pid}
+check(len(nested_compiles) == 2, f"expected the events of 2 nested cdt-cpp processes: {tools}")
+for pid in nested_compiles:
+    check(any(e["pid"] == pid and e["name"] == "clang-9" for e in events), f"nested cdt-cpp {pid} ran no clang-9")
+check(any(e["name"] == "cdt-ld" and e["pid"] != top_pid for e in tools), "the nested cdt-ld wrote no tool event")
+check(any(e["name"] == "wasm-ld" for e in events), "the link ran no wasm-ld")
+
+# the tool the user started ends last, after the nested tools have appended their events
+top = next(e for e in tools if e["name"] == "cdt-cpp" and e["pid"] == top_pid)
+for e in tools:
+    check(e["ts"] + e["dur"] <= top["ts"] + top["dur"], f"{e} ends after the top-level cdt-cpp")
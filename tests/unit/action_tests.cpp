@@ -0,0 +1,109 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <eosio/action.hpp>
+#include <eosio/contract.hpp>
+#include <eosio/tester.hpp>
+
+using std::make_tuple;
+using std::string;
+using std::vector;
+
+using eosio::action;
+using eosio::action_wrapper;
+using eosio::name;
+using eosio::pack;
+using eosio::permission_level;
+using eosio::native::intrinsics;
+
+struct test_contract : public eosio::contract {
+   using eosio::contract::contract;
+   void hi( string memo, uint64_t n ) {}
+};
+
+using hi_action = action_wrapper<"hi"_n, &test_contract::hi>;
+
+// The action passed to the last `send_inline` or `send_context_free_inline`
+static vector<char> sent;
+static vector<char> sent_context_free;
+
+static void record_sends() {
+   intrinsics::set_intrinsic<intrinsics::send_inline>([](char* data, size_t size) {
+      sent.assign(data, data + size);
+   });
+   intrinsics::set_intrinsic<intrinsics::send_context_free_inline>([](char* data, size_t size) {
+      sent_context_free.assign(data, data + size);
+   });
+}
+
+// Sends an action with a `memo` of `memo_size` bytes by every path and compares what reaches the
+// intrinsics with `pack(action{...})`
+static void check_sends( size_t memo_size ) {
+   const string memo(memo_size, 'm');
+   const uint64_t n = 42;
+   const vector<permission_level> auths{ {"alice"_n, "active"_n}, {"bob"_n, "owner"_n} };
+   const auto expected = pack(action{auths, "test"_n, "hi"_n, make_tuple(memo, n)});
+   const auto expected_context_free = pack(action{vector<permission_level>{}, "test"_n, "hi"_n, make_tuple(memo, n)});
+
+   sent.clear();
+   eosio::send_inline_action("test"_n, "hi"_n, auths, memo, n);
+   CHECK_EQUAL( sent, expected )
+
+   sent.clear();
+   action{auths, "test"_n, "hi"_n, make_tuple(memo, n)}.send();
+   CHECK_EQUAL( sent, expected )
+
+   sent.clear();
+   hi_action{"test"_n, auths}.send(memo, n);
+   CHECK_EQUAL( sent, expected )
+
+   sent.clear();
+   eosio::dispatch_inline("test"_n, "hi"_n, auths, make_tuple(memo, n));
+   CHECK_EQUAL( sent, expected )
+
+   sent_context_free.clear();
+   eosio::send_context_free_inline_action("test"_n, "hi"_n, memo, n);
+   CHECK_EQUAL( sent_context_free, expected_context_free )
+
+   sent_context_free.clear();
+   action{vector<permission_level>{}, "test"_n, "hi"_n, make_tuple(memo, n)}.send_context_free();
+   CHECK_EQUAL( sent_context_free, expected_context_free )
+
+   sent_context_free.clear();
+   hi_action{"test"_n, vector<permission_level>{}}.send_context_free(memo, n);
+   CHECK_EQUAL( sent_context_free, expected_context_free )
+}
+
+// Definitions in `eosio.cdt/libraries/eosiolib/contracts/eosio/action.hpp`
+EOSIO_TEST_BEGIN(send_inline_action_test)
+   record_sends();
+
+   // serialized on the stack
+   check_sends(10);
+   // larger than the stack buffer of 512 bytes, serialized into the scratch buffer
+   check_sends(2000);
+   // the scratch buffer is reused
+   check_sends(3000);
+   check_sends(600);
+
+   CHECK_ASSERT( "context free actions cannot have authorizations", []() {
+      hi_action{"test"_n, permission_level{"alice"_n, "active"_n}}.send_context_free(string{"memo"}, uint64_t{1});
+   });
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(send_inline_action_test)
+   return has_failed();
+}
@@ -0,0 +1,153 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <eosio/call.hpp>
+#include <eosio/tester.hpp>
+
+using std::make_tuple;
+using std::string;
+using std::vector;
+
+using eosio::access_mode;
+using eosio::call_batch;
+using eosio::call_data_header;
+using eosio::call_wrapper;
+using eosio::pack;
+using eosio::support_mode;
+using eosio::native::intrinsics;
+
+struct callee {
+   string get( string key, uint64_t n ) { return {}; }
+};
+
+using get_func = call_wrapper<"get"_i, &callee::get>;
+using get_read_only_func = call_wrapper<"get"_i, &callee::get, access_mode::read_only>;
+using get_no_op_func = call_wrapper<"get"_i, &callee::get, access_mode::read_write, support_mode::no_op>;
+
+// The data and flags of the last `call`, and the packed value it returns
+static vector<char> sent;
+static uint64_t sent_flags = 0;
+static vector<char> return_value;
+static bool supported = true;
+
+static void record_calls() {
+   intrinsics::set_intrinsic<intrinsics::call>([](uint64_t receiver, uint64_t flags, const char* data, size_t size) -> int64_t {
+      sent.assign(data, data + size);
+      sent_flags = flags;
+      return supported ? return_value.size() : -1;
+   });
+   intrinsics::set_intrinsic<intrinsics::get_call_return_value>([](void* mem, uint32_t len) -> uint32_t {
+      memcpy(mem, return_value.data(), len);
+      return len;
+   });
+}
+
+// Calls `get` with a key and a return value of `size` bytes, compares the call data with the layout
+// `pack(std::forward_as_tuple(header, args))` and checks the returned value
+static void check_call( size_t size ) {
+   const string key(size, 'k');
+   const string value(size, 'v');
+   const auto expected = pack(make_tuple(call_data_header{0, eosio::hash_id("get").id}, make_tuple(key, uint64_t{7})));
+   return_value = pack(value);
+
+   sent.clear();
+   CHECK_EQUAL( get_func{"callee"_n}(key, 7), value )
+   CHECK_EQUAL( sent, expected )
+   CHECK_EQUAL( sent_flags, 0 )
+
+   sent.clear();
+   CHECK_EQUAL( get_read_only_func{"callee"_n}(key, 7), value )
+   CHECK_EQUAL( sent, expected )
+   CHECK_EQUAL( sent_flags, 1 )
+
+   sent.clear();
+   CHECK_EQUAL( get_no_op_func{"callee"_n}(key, 7), std::optional<string>{value} )
+   CHECK_EQUAL( sent, expected )
+}
+
+// Definitions in `eosio.cdt/libraries/eosiolib/contracts/eosio/call.hpp`
+EOSIO_TEST_BEGIN(call_wrapper_test)
+   record_calls();
+
+   // packed and returned on the stack
+   check_call(10);
+   // larger than the stack buffer of 512 bytes, packed and returned in the scratch buffer
+   check_call(3000);
+   // the scratch buffer is reused
+   check_call(5000);
+   check_call(1000);
+
+   supported = false;
+   return_value = pack(string{"unused"});
+   CHECK_EQUAL( get_no_op_func{"callee"_n}(string{"key"}, 7), std::nullopt )
+   CHECK_ASSERT( "receiver does not support sync call but support_mode is set to abort_op", []() { get_func{"callee"_n}(string{"key"}, 7); } )
+   supported = true;
+EOSIO_TEST_END
+
+// Entry of `get` as codegen generates it for the batch dispatcher
+static void get_entry( uint64_t receiver, void* ds_ptr, void* result_ptr ) {
+   auto& ds = *static_cast<eosio::datastream<const char*>*>(ds_ptr);
+   string key;
+   uint64_t n;
+   ds >> key >> n;
+   *static_cast<vector<char>*>(result_ptr) = pack(key + std::to_string(n));
+}
+
+static void put_entry( uint64_t receiver, void* ds_ptr, void* result_ptr ) {}
+
+// The value set by the last `set_call_return_value`
+static vector<char> call_return_value;
+
+// Definitions in `eosio.cdt/libraries/eosiolib/contracts/eosio/call.hpp`
+EOSIO_TEST_BEGIN(execute_call_batch_test)
+   record_calls();
+   intrinsics::set_intrinsic<intrinsics::set_call_return_value>([](void* mem, uint32_t len) {
+      call_return_value.assign(static_cast<const char*>(mem), static_cast<const char*>(mem) + len);
+   });
+
+   // the hash_ids are sorted, as in the dispatcher generated by cdt-ld
+   uint64_t ids[] = { eosio::hash_id("get").id, eosio::hash_id("put").id };
+   eosio::detail::batch_call_entry entries[] = { &get_entry, &put_entry };
+   if (ids[0] > ids[1]) {
+      std::swap(ids[0], ids[1]);
+      std::swap(entries[0], entries[1]);
+   }
+
+   // the batch sent by `call_batch` is executed by the receiver
+   return_value = pack(vector<vector<char>>{});
+   call_batch{"callee"_n}.add<get_func>(string{"a"}, 1).add<get_func>(string{"b"}, 2).send();
+   eosio::detail::execute_call_batch("callee"_n.value, sent.data(), sent.size(), ids, entries, 2);
+   CHECK_EQUAL( eosio::unpack<vector<vector<char>>>(call_return_value), (vector<vector<char>>{pack(string{"a1"}), pack(string{"b2"})}) )
+
+   const uint64_t put_ids[] = { eosio::hash_id("put").id };
+   const eosio::detail::batch_call_entry put_entries[] = { &put_entry };
+   CHECK_ASSERT( "unknown sync call in batch", [&]() {
+      eosio::detail::execute_call_batch("callee"_n.value, sent.data(), sent.size(), put_ids, put_entries, 1);
+   } )
+
+   // a count of calls the data can't hold is rejected before the results are allocated
+   const vector<char> truncated = pack(make_tuple(call_data_header{0, call_batch::batch_function_name.id}, eosio::unsigned_int{0x7fffffff}));
+   CHECK_ASSERT( "sync call batch is truncated", [&]() {
+      eosio::detail::execute_call_batch("callee"_n.value, truncated.data(), truncated.size(), ids, entries, 2);
+   } )
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(call_wrapper_test)
+   EOSIO_TEST(execute_call_batch_test)
+   return has_failed();
+}
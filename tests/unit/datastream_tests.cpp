@@ -7,7 +7,9 @@
 #include <deque>
 #include <list>
 #include <set>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <eosio/tester.hpp>
@@ -46,6 +48,7 @@ using eosio::signature;
 using eosio::symbol;
 using eosio::symbol_code;
 using eosio::unpack;
+using eosio::with_packed;
 
 // This data structure (which cannot be defined within a test macro block) needs both a default and a
 // user-defined constructor for a specific `binary extension` test
@@ -392,6 +395,34 @@ EOSIO_TEST_BEGIN(datastream_stream_test)
    ds >> str;
    CHECK_EQUAL( cstr, str )
 
+   // ----------------
+   // std::string_view
+   ds.seekp(0);
+   fill(begin(datastream_buffer), end(datastream_buffer), 0);
+   static const std::string_view csv {"abcdefghi"};
+   std::string_view sv{};
+   ds << csv;
+   ds.seekp(0);
+   ds >> sv;
+   CHECK_EQUAL( csv, sv )
+   CHECK_EQUAL( datastream_buffer+1, sv.data() )
+
+   ds.seekp(0);
+   ds >> str;
+   CHECK_EQUAL( string{csv}, str )
+
+   // -----------------------
+   // std::span<const char>
+   ds.seekp(0);
+   fill(begin(datastream_buffer), end(datastream_buffer), 0);
+   static const vector<char> cbytes{'a','b','c','d','e'};
+   std::span<const char> bytes_view{};
+   ds << std::span<const char>{cbytes};
+   ds.seekp(0);
+   ds >> bytes_view;
+   CHECK_EQUAL( cbytes, vector<char>(bytes_view.begin(), bytes_view.end()) )
+   CHECK_EQUAL( datastream_buffer+1, bytes_view.data() )
+
    // -----------
    // std::basic_string<uint8_t>
    ds.seekp(0);
@@ -631,6 +662,55 @@ EOSIO_TEST_BEGIN(misc_datastream_test)
       unpack_ch = unpack<char>(unpack_source_buffer+i, 9);
       CHECK_EQUAL( unpack_source_buffer[i], unpack_ch )
    }
+
+   // ----------------------------------
+   // decltype(auto) with_packed(const T&, F&&)
+   const auto packed_equals = [](const auto& value) {
+      return with_packed(value, [&](const char* data, size_t size) {
+         const auto expected = pack(value);
+         return size == expected.size() && memcmp(data, expected.data(), size) == 0;
+      });
+   };
+   static const vector<char> with_packed_small(16, 'a');
+   static const vector<char> with_packed_large(2048, 'b');
+   CHECK_EQUAL( packed_equals(pack_str), true )
+   CHECK_EQUAL( packed_equals(with_packed_small), true )
+   CHECK_EQUAL( packed_equals(with_packed_large), true )
+   // the heap buffer is reused, and a nested large pack doesn't overwrite the outer one
+   CHECK_EQUAL( packed_equals(with_packed_large), true )
+   CHECK_EQUAL( with_packed(with_packed_large, [&](const char* data, size_t size) {
+      const bool inner = packed_equals(vector<char>(4096, 'c'));
+      return inner && size == pack_size(with_packed_large) && memcmp(data, pack(with_packed_large).data(), size) == 0;
+   }), true )
+EOSIO_TEST_END
+
+// Definitions in `eosio.cdt/libraries/eosio/datastream.hpp`
+EOSIO_TEST_BEGIN(pack_scratch_buffer_test)
+   // packs growing a little each time reallocate the scratch buffer a few times only
+   const auto& scratch = eosio::detail::get_pack_scratch_buffer();
+   size_t capacity      = scratch.capacity;
+   size_t reallocations = 0;
+   for (size_t size = 600; size <= 64 * 1024; size += 100) {
+      eosio::detail::with_scratch_buffer<512>(size, [&](char* buffer) {
+         memset(buffer, 'x', size);
+      });
+      CHECK_EQUAL( scratch.capacity >= size, true )
+      if (scratch.capacity != capacity) {
+         ++reallocations;
+         capacity = scratch.capacity;
+      }
+   }
+   CHECK_EQUAL( reallocations <= 8, true )
+
+   // the contents are kept when it grows
+   static const vector<char> small_value(1000, 'd');
+   static const vector<char> large_value(4 * scratch.capacity, 'e');
+   CHECK_EQUAL( with_packed(small_value, [&](const char* data, size_t size) {
+      return size == pack_size(small_value) && memcmp(data, pack(small_value).data(), size) == 0;
+   }), true )
+   CHECK_EQUAL( with_packed(large_value, [&](const char* data, size_t size) {
+      return size == pack_size(large_value) && memcmp(data, pack(large_value).data(), size) == 0;
+   }), true )
 EOSIO_TEST_END
 
 int main(int argc, char* argv[]) {
@@ -644,5 +724,6 @@ int main(int argc, char* argv[]) {
    EOSIO_TEST(datastream_specialization_test);
    EOSIO_TEST(datastream_stream_test);
    EOSIO_TEST(misc_datastream_test);
+   EOSIO_TEST(pack_scratch_buffer_test);
    return has_failed();
 }
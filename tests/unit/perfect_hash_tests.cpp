@@ -0,0 +1,71 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <eosio/tester.hpp>
+#include <eosio/name.hpp>
+#include <eosio/perfect_hash.hpp>
+
+using eosio::name;
+using eosio::detail::make_perfect_hash;
+
+static constexpr uint64_t action_names[] = {
+   "transfer"_n.value, "issue"_n.value, "retire"_n.value, "open"_n.value, "close"_n.value,
+   "create"_n.value, "setprods"_n.value, "setpriv"_n.value, "setalimits"_n.value, "setparams"_n.value,
+   "reqauth"_n.value, "activate"_n.value, "updateauth"_n.value, "deleteauth"_n.value, "linkauth"_n.value,
+   "unlinkauth"_n.value, "canceldelay"_n.value, "onerror"_n.value, "setabi"_n.value, "setcode"_n.value,
+   "newaccount"_n.value, "buyram"_n.value, "sellram"_n.value, "delegatebw"_n.value, "undelegatebw"_n.value,
+   "refund"_n.value, "regproducer"_n.value, "unregprod"_n.value, "voteproducer"_n.value, "claimrewards"_n.value,
+   "rmvproducer"_n.value, "bidname"_n.value, "bidrefund"_n.value
+};
+
+// Definitions in `eosio.cdt/libraries/eosiolib/core/eosio/perfect_hash.hpp`
+EOSIO_TEST_BEGIN(perfect_hash_test)
+   static constexpr auto table = make_perfect_hash( action_names );
+   static_assert( table.valid );
+
+   for (std::size_t i = 0; i < std::size(action_names); ++i) {
+      CHECK_EQUAL( table.find(action_names[i]), static_cast<int32_t>(i) )
+   }
+   CHECK_EQUAL( table.find("nosuchaction"_n.value), -1 )
+   CHECK_EQUAL( table.find(0), -1 )
+
+   static_assert( table.find("transfer"_n.value) == 0 );
+   static_assert( table.find("bidrefund"_n.value) == 32 );
+
+   // ------------------------
+   // single key and no keys
+   static constexpr uint64_t one[] = { "hi"_n.value };
+   static_assert( make_perfect_hash( one ).valid );
+   static_assert( make_perfect_hash( one ).find("hi"_n.value) == 0 );
+   static_assert( make_perfect_hash( one ).find("check"_n.value) == -1 );
+
+   static_assert( eosio::detail::perfect_hash<0>{}.find("hi"_n.value) == -1 );
+
+   // ---------------
+   // duplicate keys
+   static constexpr uint64_t dup[] = { "hi"_n.value, "check"_n.value, "hi"_n.value };
+   static_assert( !make_perfect_hash( dup ).valid );
+   static_assert( make_perfect_hash( dup ).duplicate_keys );
+   static_assert( !make_perfect_hash( dup ).seed_not_found );
+   static_assert( !table.duplicate_keys && !table.seed_not_found );
+
+   // ---------------------------
+   // seed search giving up
+   static constexpr auto no_seed = make_perfect_hash( action_names, 1 );
+   static_assert( !no_seed.valid );
+   static_assert( no_seed.seed_not_found );
+   static_assert( !no_seed.duplicate_keys );
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(perfect_hash_test);
+   return has_failed();
+}
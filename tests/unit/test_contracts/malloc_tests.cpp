@@ -68,6 +68,43 @@ class [[eosio::contract]] malloc_tests : public contract{
          malloc_align_test<__int128_t>();
       }
 
+      [[eosio::action]]
+      void reallocpass() {
+         // grow the most recent allocation well past a page boundary
+         char* ptr0 = (char*)malloc(16);
+         for (size_t i = 0; i < 16; ++i)
+            ptr0[i] = (char)i;
+         for (size_t sz = 32; sz <= 2*64*1024; sz *= 2) {
+            ptr0 = (char*)realloc(ptr0, sz);
+            for (size_t i = sz/2; i < sz; ++i)
+               ptr0[i] = (char)i;
+         }
+         for (size_t i = 0; i < 2*64*1024; ++i)
+            eosio::check(ptr0[i] == (char)i, "wrong value after growing last allocation");
+
+         // growing a block which is not the last allocation must not clobber its neighbour
+         char* ptr1 = (char*)malloc(16);
+         char* ptr2 = (char*)malloc(16);
+         for (size_t i = 0; i < 16; ++i) {
+            ptr1[i] = 0x11;
+            ptr2[i] = 0x22;
+         }
+         ptr1 = (char*)realloc(ptr1, 64);
+         for (size_t i = 16; i < 64; ++i)
+            ptr1[i] = 0x33;
+         for (size_t i = 0; i < 16; ++i) {
+            eosio::check(ptr1[i] == 0x11, "wrong value after growing inner allocation");
+            eosio::check(ptr2[i] == 0x22, "neighbour clobbered by realloc");
+         }
+      }
+
+      [[eosio::action]]
+      void reallocfail() {
+         // a size wrapping the top of the heap around must not be taken as an in place resize
+         char* ptr = (char*)malloc(16);
+         realloc(ptr, SIZE_MAX - 8);
+      }
+
       [[eosio::action]]
       void mallocfail() {
          malloc(max_heap);
@@ -173,6 +173,22 @@ public:
       eosio::check(status == -10000, "call did not return -10000 for invalid version");
    }
 
+   // Using call_batch, several calls in one sync call
+   [[eosio::action]]
+   void wrpbatchtst() {
+      auto results = eosio::call_batch{ "callee"_n }
+                        .add<sync_call_callee::return_ten_func>()
+                        .add<sync_call_callee::void_func_func>()
+                        .add<sync_call_callee::sum_func>(10, 20, 30)
+                        .add<sync_call_callee::echo_input_func>(5)
+                        .send();
+      eosio::check(results.size() == 4, "batch did not return 4 results");
+      eosio::check(eosio::call_batch::result_as<sync_call_callee::return_ten_func>(results[0]) == 10u, "return value not 10");
+      eosio::check(results[1].empty(), "void function returned a value");
+      eosio::check(eosio::call_batch::result_as<sync_call_callee::sum_func>(results[2]) == 60u, "sum of 10, 20, and 30 not 60");
+      eosio::check(eosio::call_batch::result_as<sync_call_callee::echo_input_func>(results[3]) == 5u, "return value not 5");
+   }
+
    // Call issynccall as a sync call and return its return value
    [[eosio::action]]
    bool makesynccall() {
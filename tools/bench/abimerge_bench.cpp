@@ -0,0 +1,83 @@
+// Times ABIMerger::merge over synthetic ABIs, as produced when linking many translation units.
+// usage: abimerge_bench [structs per ABI] [ABIs to merge]
+
+#include <eosio/abimerge.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+   // An ABI of `count` structs, actions and tables. ABIs with consecutive `offset`s share half of their definitions.
+   ojson make_abi(size_t count, size_t offset) {
+      ojson abi;
+      abi["____comment"] = "synthetic ABI";
+      abi["version"] = "eosio::abi/1.2";
+      abi["types"] = ojson::array();
+      abi["structs"] = ojson::array();
+      abi["actions"] = ojson::array();
+      abi["tables"] = ojson::array();
+      abi["ricardian_clauses"] = ojson::array();
+      abi["variants"] = ojson::array();
+      abi["action_results"] = ojson::array();
+      for (size_t i = offset; i < offset + count; i++) {
+         const std::string name = "struct" + std::to_string(i);
+         ojson fields = ojson::array();
+         for (size_t f = 0; f < 8; f++) {
+            ojson field;
+            field["name"] = "field" + std::to_string(f);
+            field["type"] = f % 2 ? "uint64" : "string";
+            fields.push_back(field);
+         }
+         ojson st;
+         st["name"] = name;
+         st["base"] = "";
+         st["fields"] = fields;
+         abi["structs"].push_back(st);
+
+         ojson ty;
+         ty["new_type_name"] = "type" + std::to_string(i);
+         ty["type"] = name;
+         abi["types"].push_back(ty);
+
+         ojson act;
+         act["name"] = "act" + std::to_string(i);
+         act["type"] = name;
+         act["ricardian_contract"] = "";
+         abi["actions"].push_back(act);
+
+         ojson tab;
+         tab["name"] = "tab" + std::to_string(i);
+         tab["type"] = name;
+         tab["index_type"] = "i64";
+         tab["key_names"] = ojson::array();
+         tab["key_types"] = ojson::array();
+         abi["tables"].push_back(tab);
+      }
+      return abi;
+   }
+}
+
+int main(int argc, char** argv) {
+   const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+   const size_t abis  = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 16;
+
+   std::vector<ojson> inputs;
+   for (size_t i = 0; i < abis; i++)
+      inputs.push_back(make_abi(count, i * count / 2));
+
+   const auto start = std::chrono::steady_clock::now();
+   ABIMerger merger(inputs[0]);
+   ojson merged = inputs[0];
+   for (size_t i = 1; i < abis; i++) {
+      merged = merger.merge(inputs[i]);
+      merger.set_abi(merged);
+   }
+   const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+   std::cout << "merged " << abis << " ABIs of " << count << " structs into "
+             << merged["structs"].size() << " structs in " << elapsed.count() << " ms\n";
+   return 0;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdlib>
+#include <iostream>
+
+#include "src/common.h"
+#include "src/option-parser.h"
+#include "src/stream.h"
+#include "src/tools/postpass.h"
+
+using namespace wabt;
+
+static int s_verbose;
+static std::string s_infile;
+static std::string s_outfile;
+static std::unique_ptr<FileStream> s_log_stream;
+static PostPassOptions s_options;
+
+static const char s_description[] =
+R"(  Read a file in the WebAssembly binary format, strip bss or any data segment that is only initialized to zeros, remove
+  functions, globals and imports unreachable from the exports, and other post processing.
+
+  $ eosio-pp test.wasm -o test.stripped.wasm
+
+  # or original replacement
+  $ wasm2wat test.wasm
+)";
+
+static void ParseOptions(int argc, char** argv) {
+  OptionParser parser("postprocess", s_description);
+
+  parser.AddOption('v', "verbose", "Use multiple times for more info", []() {
+    s_verbose++;
+    s_log_stream = FileStream::CreateStdout();
+  });
+  parser.AddHelpOption();
+  parser.AddOption(
+      'k', "keep-unreachable",
+      "Don't remove functions, globals and imports unreachable from the exports",
+      []() { s_options.keep_unreachable = true; });
+  parser.AddOption(
+      'O', "optimize",
+      "Fold constants, simplify local accesses, flatten blocks and coalesce locals",
+      []() { s_options.optimize = true; });
+  parser.AddOption(
+      'r', "report", "Print data section and module sizes before and after",
+      []() { s_options.report = &std::cout; });
+  parser.AddOption(
+      's', "max-segments", "COUNT",
+      "Maximum number of data segments to emit, by default 1024",
+      [](const char* argument) {
+        s_options.max_segments = static_cast<uint32_t>(strtoul(argument, nullptr, 10));
+      });
+  parser.AddOption(
+      'o', "output", "FILENAME",
+      "Output file for the generated wast file, by default use stdout",
+      [](const char* argument) {
+        s_outfile = argument;
+        ConvertBackslashToSlash(&s_outfile);
+      });
+  parser.AddArgument("filename", OptionParser::ArgumentCount::One,
+                     [](const char* argument) {
+                       s_infile = argument;
+                       ConvertBackslashToSlash(&s_infile);
+                     });
+  parser.Parse(argc, argv);
+}
+
+int ProgramMain(int argc, char** argv) {
+  InitStdio();
+  ParseOptions(argc, argv);
+
+  std::vector<uint8_t> file_data;
+  Result result = ReadFile(s_infile.c_str(), &file_data);
+  if (Failed(result))
+    return 1;
+
+  s_options.filename = s_infile;
+  s_options.log_stream = s_log_stream.get();
+  std::vector<uint8_t> output;
+  if (!PostProcessModule(file_data, s_options, &output))
+    return 1;
+
+  if (s_outfile.empty()) {
+    s_outfile = s_infile;
+  }
+  OutputBuffer buffer;
+  buffer.data = std::move(output);
+  return buffer.WriteToFile(s_outfile.c_str()) != Result::Ok;
+}
+
+int main(int argc, char** argv) {
+  WABT_TRY
+  return ProgramMain(argc, argv);
+  WABT_CATCH_BAD_ALLOC_AND_EXIT
+}
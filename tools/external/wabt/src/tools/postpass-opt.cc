@@ -0,0 +1,601 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "src/tools/postpass-opt.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "src/cast.h"
+#include "src/make-unique.h"
+
+namespace wabt {
+
+namespace {
+
+// Call `f` on `exprs` and then on every expression list nested in it.
+template <typename F>
+void VisitExprLists(ExprList& exprs, F& f) {
+  f(exprs);
+  for (Expr& expr : exprs) {
+    switch (expr.type()) {
+      case ExprType::Block:
+        VisitExprLists(cast<BlockExpr>(&expr)->block.exprs, f);
+        break;
+      case ExprType::Loop:
+        VisitExprLists(cast<LoopExpr>(&expr)->block.exprs, f);
+        break;
+      case ExprType::If:
+        VisitExprLists(cast<IfExpr>(&expr)->true_.exprs, f);
+        VisitExprLists(cast<IfExpr>(&expr)->false_, f);
+        break;
+      case ExprType::IfExcept:
+        VisitExprLists(cast<IfExceptExpr>(&expr)->true_.exprs, f);
+        VisitExprLists(cast<IfExceptExpr>(&expr)->false_, f);
+        break;
+      case ExprType::Try:
+        VisitExprLists(cast<TryExpr>(&expr)->block.exprs, f);
+        VisitExprLists(cast<TryExpr>(&expr)->catch_, f);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+ExprList::iterator Prev(ExprList::iterator it) {
+  return --it;
+}
+
+ExprList::iterator Next(ExprList::iterator it) {
+  return ++it;
+}
+
+/// Constant folding
+
+enum class IntOp {
+  Add, Sub, Mul, And, Or, Xor, Shl, ShrS, ShrU, Rotl, Rotr,
+  Eq, Ne, LtS, LtU, GtS, GtU, LeS, LeU, GeS, GeU,
+};
+
+bool DecodeIntOp(Opcode opcode, IntOp* op, Type* type) {
+  switch (opcode) {
+#define WABT_INT_OP(name)        \
+    case Opcode::I32##name:      \
+      *op = IntOp::name;         \
+      *type = Type::I32;         \
+      return true;               \
+    case Opcode::I64##name:      \
+      *op = IntOp::name;         \
+      *type = Type::I64;         \
+      return true;
+    WABT_INT_OP(Add) WABT_INT_OP(Sub) WABT_INT_OP(Mul) WABT_INT_OP(And)
+    WABT_INT_OP(Or) WABT_INT_OP(Xor) WABT_INT_OP(Shl) WABT_INT_OP(ShrS)
+    WABT_INT_OP(ShrU) WABT_INT_OP(Rotl) WABT_INT_OP(Rotr) WABT_INT_OP(Eq)
+    WABT_INT_OP(Ne) WABT_INT_OP(LtS) WABT_INT_OP(LtU) WABT_INT_OP(GtS)
+    WABT_INT_OP(GtU) WABT_INT_OP(LeS) WABT_INT_OP(LeU) WABT_INT_OP(GeS)
+    WABT_INT_OP(GeU)
+#undef WABT_INT_OP
+    default:
+      return false;
+  }
+}
+
+// Division and remainder are left alone as they can trap.
+template <typename U, typename S>
+U FoldIntOp(IntOp op, U a, U b) {
+  const U bits = sizeof(U) * 8;
+  const U k = b & (bits - 1);
+  switch (op) {
+    case IntOp::Add:  return a + b;
+    case IntOp::Sub:  return a - b;
+    case IntOp::Mul:  return a * b;
+    case IntOp::And:  return a & b;
+    case IntOp::Or:   return a | b;
+    case IntOp::Xor:  return a ^ b;
+    case IntOp::Shl:  return a << k;
+    case IntOp::ShrS: return static_cast<U>(static_cast<S>(a) >> k);
+    case IntOp::ShrU: return a >> k;
+    case IntOp::Rotl: return k ? (a << k) | (a >> (bits - k)) : a;
+    case IntOp::Rotr: return k ? (a >> k) | (a << (bits - k)) : a;
+    case IntOp::Eq:   return a == b;
+    case IntOp::Ne:   return a != b;
+    case IntOp::LtS:  return static_cast<S>(a) < static_cast<S>(b);
+    case IntOp::LtU:  return a < b;
+    case IntOp::GtS:  return static_cast<S>(a) > static_cast<S>(b);
+    case IntOp::GtU:  return a > b;
+    case IntOp::LeS:  return static_cast<S>(a) <= static_cast<S>(b);
+    case IntOp::LeU:  return a <= b;
+    case IntOp::GeS:  return static_cast<S>(a) >= static_cast<S>(b);
+    case IntOp::GeU:  return a >= b;
+  }
+  WABT_UNREACHABLE;
+}
+
+bool IsCompare(IntOp op) {
+  return op >= IntOp::Eq;
+}
+
+bool GetOpcode(const Expr& expr, Opcode* opcode) {
+  switch (expr.type()) {
+    case ExprType::Binary:
+      *opcode = cast<BinaryExpr>(&expr)->opcode;
+      return true;
+    case ExprType::Compare:
+      *opcode = cast<CompareExpr>(&expr)->opcode;
+      return true;
+    case ExprType::Convert:
+      *opcode = cast<ConvertExpr>(&expr)->opcode;
+      return true;
+    default:
+      return false;
+  }
+}
+
+ConstExpr* AsConst(Expr& expr, Type type) {
+  auto c = dyn_cast<ConstExpr>(&expr);
+  return c && c->const_.type == type ? c : nullptr;
+}
+
+// fold a unary operation on the constant `c`, returns false if it is not foldable
+bool FoldUnary(Opcode opcode, ConstExpr* c) {
+  Const& v = c->const_;
+  if (opcode == Opcode::I32Eqz && v.type == Type::I32) {
+    v = Const::I32(v.u32 == 0, v.loc);
+  } else if (opcode == Opcode::I64Eqz && v.type == Type::I64) {
+    v = Const::I32(v.u64 == 0, v.loc);
+  } else if (opcode == Opcode::I64ExtendUI32 && v.type == Type::I32) {
+    v = Const::I64(v.u32, v.loc);
+  } else if (opcode == Opcode::I64ExtendSI32 && v.type == Type::I32) {
+    v = Const::I64(static_cast<int64_t>(static_cast<int32_t>(v.u32)), v.loc);
+  } else if (opcode == Opcode::I32WrapI64 && v.type == Type::I64) {
+    v = Const::I32(static_cast<uint32_t>(v.u64), v.loc);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+size_t FoldConstants(ExprList& exprs) {
+  size_t folded = 0;
+  for (auto it = exprs.begin(); it != exprs.end();) {
+    Opcode opcode;
+    if (it == exprs.begin() || !GetOpcode(*it, &opcode)) {
+      ++it;
+      continue;
+    }
+
+    auto rhs_it = Prev(it);
+    auto rhs = dyn_cast<ConstExpr>(&*rhs_it);
+    if (rhs && FoldUnary(opcode, rhs)) {
+      it = exprs.erase(it);
+      folded++;
+      continue;
+    }
+
+    IntOp op;
+    Type type;
+    if (!rhs || rhs_it == exprs.begin() || !DecodeIntOp(opcode, &op, &type) ||
+        rhs->const_.type != type) {
+      ++it;
+      continue;
+    }
+    auto lhs_it = Prev(rhs_it);
+    ConstExpr* lhs = AsConst(*lhs_it, type);
+    if (!lhs) {
+      ++it;
+      continue;
+    }
+
+    Const& v = lhs->const_;
+    if (type == Type::I32) {
+      uint32_t r = FoldIntOp<uint32_t, int32_t>(op, v.u32, rhs->const_.u32);
+      v = Const::I32(r, v.loc);
+    } else {
+      uint64_t r = FoldIntOp<uint64_t, int64_t>(op, v.u64, rhs->const_.u64);
+      v = IsCompare(op) ? Const::I32(static_cast<uint32_t>(r), v.loc)
+                        : Const::I64(r, v.loc);
+    }
+    exprs.erase(rhs_it);
+    it = exprs.erase(it);
+    folded++;
+  }
+  return folded;
+}
+
+/// local.get/local.set peepholes
+
+template <ExprType T>
+bool IsLocalOp(const Expr& expr, Index* index) {
+  auto local = dyn_cast<VarExpr<T>>(&expr);
+  if (!local)
+    return false;
+  *index = local->var.index();
+  return true;
+}
+
+size_t SimplifyLocalOps(ExprList& exprs) {
+  size_t removed = 0;
+  for (auto it = exprs.begin(); it != exprs.end();) {
+    auto next = Next(it);
+    if (next == exprs.end())
+      break;
+
+    Index a, b;
+    bool changed = true;
+    if (IsLocalOp<ExprType::SetLocal>(*it, &a) &&
+        IsLocalOp<ExprType::GetLocal>(*next, &b) && a == b) {
+      // local.set x; local.get x => local.tee x
+      Location loc = it->loc;
+      exprs.erase(next);
+      it = exprs.insert(exprs.erase(it), MakeUnique<TeeLocalExpr>(Var(a, loc)));
+      removed++;
+    } else if (IsLocalOp<ExprType::TeeLocal>(*it, &a) &&
+               next->type() == ExprType::Drop) {
+      // local.tee x; drop => local.set x
+      Location loc = it->loc;
+      exprs.erase(next);
+      it = exprs.insert(exprs.erase(it), MakeUnique<SetLocalExpr>(Var(a, loc)));
+      removed++;
+    } else if ((it->type() == ExprType::GetLocal ||
+                it->type() == ExprType::Const) &&
+               next->type() == ExprType::Drop) {
+      // value without side effects which is dropped
+      exprs.erase(next);
+      it = exprs.erase(it);
+      removed += 2;
+    } else if (IsLocalOp<ExprType::GetLocal>(*it, &a) &&
+               IsLocalOp<ExprType::SetLocal>(*next, &b) && a == b) {
+      // local.get x; local.set x
+      exprs.erase(next);
+      it = exprs.erase(it);
+      removed += 2;
+    } else if (IsLocalOp<ExprType::GetLocal>(*it, &a) &&
+               IsLocalOp<ExprType::TeeLocal>(*next, &b) && a == b) {
+      // local.get x; local.tee x => local.get x, left by coalescing a copy
+      exprs.erase(next);
+      removed++;
+    } else {
+      changed = false;
+    }
+
+    if (!changed)
+      ++it;
+    else if (it != exprs.begin())
+      --it;  // the new neighbour may form another pattern
+  }
+  return removed;
+}
+
+/// Block flattening
+
+// Visit every branch target in `exprs`, `depth` being the number of labels
+// between the expressions and the label of interest.
+template <typename F>
+void VisitBranches(ExprList& exprs, Index depth, F& f) {
+  for (Expr& expr : exprs) {
+    switch (expr.type()) {
+      case ExprType::Br:
+        f(cast<BrExpr>(&expr)->var, depth);
+        break;
+      case ExprType::BrIf:
+        f(cast<BrIfExpr>(&expr)->var, depth);
+        break;
+      case ExprType::BrTable: {
+        auto br_table = cast<BrTableExpr>(&expr);
+        for (Var& var : br_table->targets)
+          f(var, depth);
+        f(br_table->default_target, depth);
+        break;
+      }
+      case ExprType::Block:
+        VisitBranches(cast<BlockExpr>(&expr)->block.exprs, depth + 1, f);
+        break;
+      case ExprType::Loop:
+        VisitBranches(cast<LoopExpr>(&expr)->block.exprs, depth + 1, f);
+        break;
+      case ExprType::If:
+        VisitBranches(cast<IfExpr>(&expr)->true_.exprs, depth + 1, f);
+        VisitBranches(cast<IfExpr>(&expr)->false_, depth + 1, f);
+        break;
+      case ExprType::IfExcept:
+        VisitBranches(cast<IfExceptExpr>(&expr)->true_.exprs, depth + 1, f);
+        VisitBranches(cast<IfExceptExpr>(&expr)->false_, depth + 1, f);
+        break;
+      case ExprType::Try:
+        VisitBranches(cast<TryExpr>(&expr)->block.exprs, depth + 1, f);
+        VisitBranches(cast<TryExpr>(&expr)->catch_, depth + 1, f);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+// Splice the body of every block or loop which is never branched to into its
+// parent, the branches crossing the removed label are renumbered.
+size_t FlattenBlocks(ExprList& exprs) {
+  size_t flattened = 0;
+  for (auto it = exprs.begin(); it != exprs.end();) {
+    Block* block = nullptr;
+    if (auto b = dyn_cast<BlockExpr>(&*it))
+      block = &b->block;
+    else if (auto l = dyn_cast<LoopExpr>(&*it))
+      block = &l->block;
+    if (!block) {
+      ++it;
+      continue;
+    }
+
+    bool targeted = false;
+    auto find_target = [&](Var& var, Index depth) {
+      targeted |= var.index() == depth;
+    };
+    VisitBranches(block->exprs, 0, find_target);
+    if (targeted) {
+      ++it;
+      continue;
+    }
+
+    auto shift = [](Var& var, Index depth) {
+      if (var.index() > depth)
+        var.set_index(var.index() - 1);
+    };
+    VisitBranches(block->exprs, 0, shift);
+    // continue with the first spliced expression, it may be a nested block
+    bool at_begin = it == exprs.begin();
+    auto before = at_begin ? it : Prev(it);
+    exprs.splice(it, block->exprs);
+    exprs.erase(it);
+    it = at_begin ? exprs.begin() : Next(before);
+    flattened++;
+  }
+  return flattened;
+}
+
+/// Local coalescing
+
+struct LocalRange {
+  Index first = kInvalidIndex;
+  Index last = 0;
+  Index start = kInvalidIndex;
+  Index end = 0;
+  bool first_is_set = false;
+  Index first_list = kInvalidIndex;
+};
+
+class LocalScanner {
+ public:
+  LocalScanner(Func* func) : func_(func), ranges_(func->GetNumParamsAndLocals()) {}
+
+  void Scan() {
+    ScanList(func_->exprs);
+    for (auto& r : ranges_) {
+      if (r.first == kInvalidIndex)
+        continue;
+      r.start = std::min(r.start, r.first);
+      r.end = std::max(r.end, r.last);
+    }
+  }
+
+  const std::vector<LocalRange>& ranges() const { return ranges_; }
+
+  // the first access is a write and every other access follows it in the same
+  // expression list, so no access observes the previous value of the slot
+  bool Dominated(const LocalRange& r) const {
+    return r.first_is_set && r.last <= list_end_[r.first_list];
+  }
+
+ private:
+  void Access(const Var& var, bool is_set) {
+    LocalRange& r = ranges_[var.index()];
+    if (r.first == kInvalidIndex) {
+      r.first = pos_;
+      r.first_is_set = is_set;
+      r.first_list = lists_.back();
+    }
+    r.last = pos_;
+    // a value can flow around a loop's back edge, the local is live for the
+    // whole outermost enclosing loop
+    if (!loops_.empty()) {
+      pending_.push_back(std::make_pair(var.index(), loops_.front()));
+    }
+  }
+
+  void ScanList(ExprList& exprs) {
+    Index list = list_end_.size();
+    list_end_.push_back(0);
+    lists_.push_back(list);
+    for (Expr& expr : exprs) {
+      pos_++;
+      switch (expr.type()) {
+        case ExprType::GetLocal:
+          Access(cast<GetLocalExpr>(&expr)->var, false);
+          break;
+        case ExprType::SetLocal:
+          Access(cast<SetLocalExpr>(&expr)->var, true);
+          break;
+        case ExprType::TeeLocal:
+          Access(cast<TeeLocalExpr>(&expr)->var, true);
+          break;
+        case ExprType::Block:
+          ScanList(cast<BlockExpr>(&expr)->block.exprs);
+          break;
+        case ExprType::Loop: {
+          Index loop = loop_start_.size();
+          loop_start_.push_back(pos_);
+          loop_end_.push_back(0);
+          loops_.push_back(loop);
+          ScanList(cast<LoopExpr>(&expr)->block.exprs);
+          loops_.pop_back();
+          loop_end_[loop] = pos_;
+          if (loops_.empty())
+            ExtendOverLoops();
+          break;
+        }
+        case ExprType::If:
+          ScanList(cast<IfExpr>(&expr)->true_.exprs);
+          ScanList(cast<IfExpr>(&expr)->false_);
+          break;
+        case ExprType::IfExcept:
+          ScanList(cast<IfExceptExpr>(&expr)->true_.exprs);
+          ScanList(cast<IfExceptExpr>(&expr)->false_);
+          break;
+        case ExprType::Try:
+          ScanList(cast<TryExpr>(&expr)->block.exprs);
+          ScanList(cast<TryExpr>(&expr)->catch_);
+          break;
+        default:
+          break;
+      }
+    }
+    lists_.pop_back();
+    list_end_[list] = pos_;
+  }
+
+  void ExtendOverLoops() {
+    for (auto& p : pending_) {
+      LocalRange& r = ranges_[p.first];
+      r.start = std::min(r.start, loop_start_[p.second]);
+      r.end = std::max(r.end, loop_end_[p.second]);
+    }
+    pending_.clear();
+  }
+
+  Func* func_;
+  std::vector<LocalRange> ranges_;
+  Index pos_ = 0;
+  std::vector<Index> lists_;
+  std::vector<Index> list_end_;
+  std::vector<Index> loops_;
+  std::vector<Index> loop_start_;
+  std::vector<Index> loop_end_;
+  std::vector<std::pair<Index, Index>> pending_;
+};
+
+// Give locals whose live ranges don't overlap the same slot and drop unused
+// locals. Parameters keep their index.
+void CoalesceLocals(Func* func) {
+  const Index num_params = func->GetNumParams();
+  const Index num_locals = func->GetNumParamsAndLocals();
+  if (num_locals == num_params)
+    return;
+
+  LocalScanner scanner(func);
+  scanner.Scan();
+  const auto& ranges = scanner.ranges();
+
+  std::vector<Index> order;
+  for (Index i = num_params; i < num_locals; ++i) {
+    if (ranges[i].first != kInvalidIndex)
+      order.push_back(i);
+  }
+  std::stable_sort(order.begin(), order.end(), [&](Index a, Index b) {
+    return ranges[a].start < ranges[b].start;
+  });
+
+  struct Slot {
+    Type type;
+    Index end;
+  };
+  std::vector<Slot> slots;
+  std::vector<Index> slot_of(num_locals, kInvalidIndex);
+  for (Index local : order) {
+    const LocalRange& r = ranges[local];
+    Type type = func->GetLocalType(Var(local));
+    Index chosen = kInvalidIndex;
+    if (scanner.Dominated(r)) {
+      for (Index s = 0; s < slots.size(); ++s) {
+        if (slots[s].type == type && slots[s].end < r.start) {
+          chosen = s;
+          break;
+        }
+      }
+    }
+    if (chosen == kInvalidIndex) {
+      chosen = slots.size();
+      slots.push_back({type, r.end});
+    } else {
+      slots[chosen].end = r.end;
+    }
+    slot_of[local] = chosen;
+  }
+
+  // group slots by type so the local declarations encode compactly
+  std::vector<Index> slot_order(slots.size());
+  for (Index s = 0; s < slots.size(); ++s)
+    slot_order[s] = s;
+  std::stable_sort(slot_order.begin(), slot_order.end(), [&](Index a, Index b) {
+    return slots[a].type < slots[b].type;
+  });
+  std::vector<Index> slot_index(slots.size());
+  TypeVector types;
+  for (Index s : slot_order) {
+    slot_index[s] = num_params + types.size();
+    types.push_back(slots[s].type);
+  }
+
+  auto remap = [&](Var& var) {
+    if (var.index() >= num_params)
+      var.set_index(slot_index[slot_of[var.index()]]);
+  };
+  auto remap_list = [&](ExprList& exprs) {
+    for (Expr& expr : exprs) {
+      if (auto get = dyn_cast<GetLocalExpr>(&expr))
+        remap(get->var);
+      else if (auto set = dyn_cast<SetLocalExpr>(&expr))
+        remap(set->var);
+      else if (auto tee = dyn_cast<TeeLocalExpr>(&expr))
+        remap(tee->var);
+    }
+  };
+  VisitExprLists(func->exprs, remap_list);
+
+  func->local_types.Set(types);
+  func->local_bindings.clear();
+}
+
+}  // end anonymous namespace
+
+PostLinkOptStats OptimizeModule(Module* module) {
+  PostLinkOptStats stats;
+  for (Index i = module->num_func_imports; i < module->funcs.size(); ++i) {
+    Func* func = module->funcs[i];
+    stats.locals_before += func->GetNumLocals();
+
+    auto flatten = [&](ExprList& exprs) {
+      stats.flattened_blocks += FlattenBlocks(exprs);
+    };
+    auto fold = [&](ExprList& exprs) {
+      stats.folded_constants += FoldConstants(exprs);
+    };
+    auto simplify = [&](ExprList& exprs) {
+      stats.removed_local_ops += SimplifyLocalOps(exprs);
+    };
+
+    VisitExprLists(func->exprs, flatten);
+    VisitExprLists(func->exprs, fold);
+    VisitExprLists(func->exprs, simplify);
+    CoalesceLocals(func);
+    // slots shared by coalesced locals can form new set/get pairs
+    VisitExprLists(func->exprs, simplify);
+
+    stats.locals_after += func->GetNumLocals();
+  }
+  return stats;
+}
+
+}  // namespace wabt
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WABT_POSTPASS_OPT_H_
+#define WABT_POSTPASS_OPT_H_
+
+#include <cstddef>
+
+#include "src/ir.h"
+
+namespace wabt {
+
+struct PostLinkOptStats {
+  size_t folded_constants = 0;
+  size_t removed_local_ops = 0;
+  size_t flattened_blocks = 0;
+  size_t locals_before = 0;
+  size_t locals_after = 0;
+};
+
+// Peephole optimizations run by eosio-pp on the linked module:
+//  - folding of integer operations on constants (e.g. eosio::name comparisons)
+//  - local.set/local.get pairs into local.tee, removal of redundant local copies and of dead
+//    local/const drops
+//  - flattening of blocks and loops that are never branched to
+//  - coalescing of locals with disjoint live ranges and removal of unused locals
+PostLinkOptStats OptimizeModule(Module* module);
+
+}  // namespace wabt
+
+#endif /* WABT_POSTPASS_OPT_H_ */
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <cassert>
 #include <cinttypes>
 #include <cstdio>
@@ -24,57 +25,23 @@
 #include "src/binary-reader.h"
 #include "src/binary-writer.h"
 #include "src/binary-reader-ir.h"
+#include "src/cast.h"
 #include "src/error-handler.h"
 #include "src/feature.h"
 #include "src/generate-names.h"
 #include "src/ir.h"
 #include "src/leb128.h"
-#include "src/option-parser.h"
+#include "src/make-unique.h"
 #include "src/stream.h"
 #include "src/validator.h"
 #include "src/wast-lexer.h"
 #include "src/wat-writer.h"
+#include "src/tools/postpass.h"
+#include "src/tools/postpass-opt.h"
 
 using namespace wabt;
 
-static int s_verbose;
-static std::string s_infile;
-static std::string s_outfile;
-static Features s_features;
-static WriteBinaryOptions s_write_binary_options;
-static std::unique_ptr<FileStream> s_log_stream;
-
-static const char s_description[] =
-R"(  Read a file in the WebAssembly binary format, strip bss or any data segment that is only initialized to zeros, and other post processing.
-
-  $ eosio-pp test.wasm -o test.stripped.wasm
-
-  # or original replacement
-  $ wasm2wat test.wasm
-)";
-
-static void ParseOptions(int argc, char** argv) {
-  OptionParser parser("postprocess", s_description);
-
-  parser.AddOption('v', "verbose", "Use multiple times for more info", []() {
-    s_verbose++;
-    s_log_stream = FileStream::CreateStdout();
-  });
-  parser.AddHelpOption();
-  parser.AddOption(
-      'o', "output", "FILENAME",
-      "Output file for the generated wast file, by default use stdout",
-      [](const char* argument) {
-        s_outfile = argument;
-        ConvertBackslashToSlash(&s_outfile);
-      });
-  parser.AddArgument("filename", OptionParser::ArgumentCount::One,
-                     [](const char* argument) {
-                       s_infile = argument;
-                       ConvertBackslashToSlash(&s_infile);
-                     });
-  parser.Parse(argc, argv);
-}
+namespace {
 
 uint32_t GetHeapPtr( Module& mod, const std::vector<uint8_t>& buff ) {
    size_t offset = mod.GetGlobal(Var(1))->init_expr.begin()->loc.offset;
@@ -83,13 +50,6 @@ uint32_t GetHeapPtr( Module& mod, const std::vector<uint8_t>& buff ) {
    return heap_ptr;
 }
 
-uint32_t GetStackPtr( Module& mod, const std::vector<uint8_t>& buff ) {
-   size_t offset = mod.GetGlobal(Var(0))->init_expr.begin()->loc.offset;
-   uint32_t stack_ptr;
-   ReadS32Leb128(buff.data()+offset+4, buff.data()+offset+9, &stack_ptr);
-   return stack_ptr;
-}
-
 inline bool IsZeroed(const DataSegment* ds) {
    for ( auto d : ds->data ) {
       if (d != 0)
@@ -111,10 +71,11 @@ std::vector<DataSegment*> StripZeroedData( std::vector<DataSegment*>&& ds, size_
 }
 
 inline std::vector<uint8_t> FillFromSegments(const std::vector<DataSegment*>& segments) {
-  std::vector<uint8_t> memory;  
-  auto last_segment = segments.back();
-  ConstExpr* ce = reinterpret_cast<ConstExpr*>(&(last_segment->offset.front()));
-  memory.resize(ce->const_.u32+last_segment->data.size());
+  std::vector<uint8_t> memory;
+  for (auto ds : segments) {
+    auto offset = reinterpret_cast<ConstExpr*>(&(ds->offset.front()))->const_.u32;
+    memory.resize(std::max<size_t>(memory.size(), offset+ds->data.size()));
+  }
 
   for (auto ds : segments) {
     auto offset = reinterpret_cast<ConstExpr*>(&(ds->offset.front()))->const_.u32;
@@ -139,36 +100,338 @@ inline DataSegment* CreateSegment(uint32_t offset, uint8_t* start, std::size_t s
    return segment;
 }
 
-inline std::vector<DataSegment*> CreateSegments(std::vector<uint8_t> memory) {
-   std::vector<DataSegment*> segments;
+// encoded size of the signed LEB128 immediate of an `i32.const`
+inline uint32_t S32Leb128Length(uint32_t value) {
+   int32_t v = static_cast<int32_t>(value);
+   uint32_t size = 1;
+   while (v < -64 || v >= 64) {
+      v >>= 7;
+      size++;
+   }
+   return size;
+}
 
-   std::size_t f=0;
-   // look for the first non-zero entry
-   for (; f < memory.size(); ++f) {
-      if (memory[f] != 0)
-         break;
-   }
-
-   uint32_t zero_span = 0;
-   uint32_t break_size = 1024;
-   uint32_t last_offset = f;
-
-   for (std::size_t i=f; i < memory.size(); ++i) {
-      zero_span = memory[i] == 0 ? zero_span + 1 : 0;
-      std::size_t size = i - last_offset;
-      if (zero_span > 8 || (size > 1024)) {
-         segments.push_back(CreateSegment(last_offset, &memory[last_offset], size));
-         last_offset = i;
-         zero_span = 0;
-         i += size;
+// encoded size of a data segment header: memory index, `i32.const offset end` and data length
+inline uint32_t SegmentHeaderSize(uint32_t offset, uint32_t size) {
+   return 1 + 1 + S32Leb128Length(offset) + 1 + U32Leb128Length(size);
+}
+
+inline size_t EncodedSize(const std::vector<DataSegment*>& segments) {
+   size_t size = 0;
+   for (auto ds : segments) {
+      auto offset = reinterpret_cast<ConstExpr*>(&(ds->offset.front()))->const_.u32;
+      size += SegmentHeaderSize(offset, ds->data.size()) + ds->data.size();
+   }
+   return size;
+}
+
+// Cover the non-zero bytes of memory with the segments that encode smallest. Ending a
+// segment at a span of zeros saves the span but costs the header of the next segment,
+// so only spans longer than that header are worth splitting at.
+inline std::vector<DataSegment*> CreateSegments(const std::vector<uint8_t>& memory, uint32_t max_segments) {
+   struct Run { uint32_t begin; uint32_t end; };
+   struct Split { std::size_t run; int64_t savings; };
+
+   std::vector<Run> runs;
+   for (std::size_t i=0; i < memory.size();) {
+      if (memory[i] == 0) {
+         ++i;
          continue;
       }
+      uint32_t begin = i;
+      while (i < memory.size() && memory[i] != 0)
+         ++i;
+      runs.push_back({begin, static_cast<uint32_t>(i)});
+   }
+
+   std::vector<DataSegment*> segments;
+   if (runs.empty())
+      return segments;
+
+   // the size of the next segment is not known until the following split is chosen,
+   // the run starting it is used as the estimate
+   std::vector<Split> splits;
+   for (std::size_t i=1; i < runs.size(); ++i) {
+      int64_t gap = runs[i].begin - runs[i-1].end;
+      int64_t savings = gap - SegmentHeaderSize(runs[i].begin, runs[i].end - runs[i].begin);
+      if (savings > 0)
+         splits.push_back({i, savings});
+   }
+
+   // nodeos limits the number of data segments, keep the most profitable splits and leave
+   // room for the heap pointer segment
+   std::size_t max_splits = max_segments > 2 ? max_segments - 2 : 0;
+   if (splits.size() > max_splits) {
+      std::stable_sort(splits.begin(), splits.end(), [](const Split& a, const Split& b) {
+         return a.savings > b.savings;
+      });
+      splits.resize(max_splits);
+      std::sort(splits.begin(), splits.end(), [](const Split& a, const Split& b) {
+         return a.run < b.run;
+      });
    }
-   segments.push_back(CreateSegment(last_offset, &memory[last_offset], memory.size()-last_offset));
+
+   uint32_t begin = runs.front().begin;
+   for (const auto& split : splits) {
+      uint32_t end = runs[split.run-1].end;
+      segments.push_back(CreateSegment(begin, const_cast<uint8_t*>(&memory[begin]), end-begin));
+      begin = runs[split.run].begin;
+   }
+   uint32_t end = runs.back().end;
+   segments.push_back(CreateSegment(begin, const_cast<uint8_t*>(&memory[begin]), end-begin));
 
    return segments;
 }
 
+template <typename F>
+void ForEachExpr(ExprList& exprs, F&& f) {
+   for (Expr& expr : exprs) {
+      f(expr);
+      switch (expr.type()) {
+         case ExprType::Block:
+            ForEachExpr(cast<BlockExpr>(&expr)->block.exprs, f);
+            break;
+         case ExprType::Loop:
+            ForEachExpr(cast<LoopExpr>(&expr)->block.exprs, f);
+            break;
+         case ExprType::If:
+            ForEachExpr(cast<IfExpr>(&expr)->true_.exprs, f);
+            ForEachExpr(cast<IfExpr>(&expr)->false_, f);
+            break;
+         case ExprType::IfExcept:
+            ForEachExpr(cast<IfExceptExpr>(&expr)->true_.exprs, f);
+            ForEachExpr(cast<IfExceptExpr>(&expr)->false_, f);
+            break;
+         case ExprType::Try:
+            ForEachExpr(cast<TryExpr>(&expr)->block.exprs, f);
+            ForEachExpr(cast<TryExpr>(&expr)->catch_, f);
+            break;
+         default:
+            break;
+      }
+   }
+}
+
+struct RemovedCounts {
+   size_t funcs   = 0;
+   size_t imports = 0;
+   size_t globals = 0;
+};
+
+// Remove every function, global and function/global import which cannot be reached from the
+// exports (apply, sync_call and any --only-export entry), the start function or the stack
+// pointer, renumbering all references to the survivors. Table slots are runtime values and
+// keep their position; a slot whose function signature matches no reachable call_indirect can
+// only trap, so it is pointed at a single `unreachable` stub of its type instead.
+RemovedCounts RemoveUnreachable(Module& mod) {
+   std::vector<bool> live_funcs(mod.funcs.size(), false);
+   std::vector<bool> live_globals(mod.globals.size(), false);
+   // compared by signature, a module can declare the same signature under several type indices
+   std::vector<FuncSignature> indirect_sigs;
+   std::vector<Index> worklist;
+
+   auto called_indirectly = [&](const FuncSignature& sig) {
+      return std::find(indirect_sigs.begin(), indirect_sigs.end(), sig) != indirect_sigs.end();
+   };
+
+   auto mark_func = [&](const Var& var) {
+      Index index = mod.GetFuncIndex(var);
+      if (index < live_funcs.size() && !live_funcs[index]) {
+         live_funcs[index] = true;
+         worklist.push_back(index);
+      }
+   };
+   auto mark_global = [&](const Var& var) {
+      Index index = mod.GetGlobalIndex(var);
+      if (index < live_globals.size())
+         live_globals[index] = true;
+   };
+   auto mark_exprs = [&](ExprList& exprs) {
+      ForEachExpr(exprs, [&](Expr& expr) {
+         switch (expr.type()) {
+            case ExprType::Call:
+               mark_func(cast<CallExpr>(&expr)->var);
+               break;
+            case ExprType::CallIndirect: {
+               const FuncSignature& sig = cast<CallIndirectExpr>(&expr)->decl.sig;
+               if (!called_indirectly(sig))
+                  indirect_sigs.push_back(sig);
+               break;
+            }
+            case ExprType::GetGlobal:
+               mark_global(cast<GetGlobalExpr>(&expr)->var);
+               break;
+            case ExprType::SetGlobal:
+               mark_global(cast<SetGlobalExpr>(&expr)->var);
+               break;
+            default:
+               break;
+         }
+      });
+   };
+
+   // the host can call anything in a table it can see
+   bool host_table = mod.num_table_imports != 0;
+   for (auto exp : mod.exports) {
+      switch (exp->kind) {
+         case ExternalKind::Func:
+            mark_func(exp->var);
+            break;
+         case ExternalKind::Global:
+            mark_global(exp->var);
+            break;
+         case ExternalKind::Table:
+            host_table = true;
+            break;
+         default:
+            break;
+      }
+   }
+   for (auto start : mod.starts)
+      mark_func(*start);
+   // the stack pointer of wasm-ld is global 0, eosio-stack-usage finds it by its index
+   if (!live_globals.empty())
+      live_globals[0] = true;
+   for (auto global : mod.globals)
+      mark_exprs(global->init_expr);
+   for (auto ds : mod.data_segments)
+      mark_exprs(ds->offset);
+   for (auto es : mod.elem_segments)
+      mark_exprs(es->offset);
+
+   // newly reachable functions can add call_indirect signatures, iterate to a fixed point
+   std::size_t known_sigs;
+   do {
+      known_sigs = indirect_sigs.size();
+      while (!worklist.empty()) {
+         Index index = worklist.back();
+         worklist.pop_back();
+         if (index >= mod.num_func_imports)
+            mark_exprs(mod.funcs[index]->exprs);
+      }
+      for (auto es : mod.elem_segments) {
+         for (const Var& var : es->vars) {
+            Index index = mod.GetFuncIndex(var);
+            if (host_table || called_indirectly(mod.funcs[index]->decl.sig))
+               mark_func(var);
+         }
+      }
+   } while (!worklist.empty() || indirect_sigs.size() != known_sigs);
+
+   if (!host_table && indirect_sigs.empty()) {
+      mod.elem_segments.clear();
+   } else {
+      Index stub = kInvalidIndex;
+      for (auto es : mod.elem_segments) {
+         for (Var& var : es->vars) {
+            if (live_funcs[mod.GetFuncIndex(var)])
+               continue;
+            if (stub == kInvalidIndex) {
+               auto field = MakeUnique<FuncModuleField>();
+               field->func.decl = mod.funcs[mod.GetFuncIndex(var)]->decl;
+               field->func.exprs.push_back(MakeUnique<UnreachableExpr>());
+               stub = mod.funcs.size();
+               mod.AppendField(std::move(field));
+               live_funcs.push_back(true);
+            }
+            var = Var(stub);
+         }
+      }
+   }
+
+   RemovedCounts removed;
+   std::vector<Index> func_map(mod.funcs.size(), kInvalidIndex);
+   std::vector<Index> global_map(mod.globals.size(), kInvalidIndex);
+   std::vector<Func*>   funcs;
+   std::vector<Global*> globals;
+   for (Index i = 0; i < mod.funcs.size(); ++i) {
+      if (live_funcs[i]) {
+         func_map[i] = funcs.size();
+         funcs.push_back(mod.funcs[i]);
+      } else if (i >= mod.num_func_imports) {
+         removed.funcs++;
+      }
+   }
+   for (Index i = 0; i < mod.globals.size(); ++i) {
+      if (live_globals[i]) {
+         global_map[i] = globals.size();
+         globals.push_back(mod.globals[i]);
+      } else if (i >= mod.num_global_imports) {
+         removed.globals++;
+      }
+   }
+
+   std::vector<Import*> imports;
+   Index func_import = 0;
+   Index global_import = 0;
+   Index num_func_imports = 0;
+   Index num_global_imports = 0;
+   for (auto import : mod.imports) {
+      bool live = true;
+      if (import->kind() == ExternalKind::Func) {
+         live = live_funcs[func_import++];
+         num_func_imports += live;
+      } else if (import->kind() == ExternalKind::Global) {
+         live = live_globals[global_import++];
+         num_global_imports += live;
+      }
+      if (live)
+         imports.push_back(import);
+      else
+         removed.imports++;
+   }
+
+   auto remap_func = [&](Var& var) { var = Var(func_map[mod.GetFuncIndex(var)], var.loc); };
+   auto remap_global = [&](Var& var) { var = Var(global_map[mod.GetGlobalIndex(var)], var.loc); };
+   auto remap_exprs = [&](ExprList& exprs) {
+      ForEachExpr(exprs, [&](Expr& expr) {
+         switch (expr.type()) {
+            case ExprType::Call:
+               remap_func(cast<CallExpr>(&expr)->var);
+               break;
+            case ExprType::GetGlobal:
+               remap_global(cast<GetGlobalExpr>(&expr)->var);
+               break;
+            case ExprType::SetGlobal:
+               remap_global(cast<SetGlobalExpr>(&expr)->var);
+               break;
+            default:
+               break;
+         }
+      });
+   };
+
+   for (auto func : funcs)
+      remap_exprs(func->exprs);
+   for (auto global : globals)
+      remap_exprs(global->init_expr);
+   for (auto ds : mod.data_segments)
+      remap_exprs(ds->offset);
+   for (auto es : mod.elem_segments) {
+      remap_exprs(es->offset);
+      for (Var& var : es->vars)
+         remap_func(var);
+   }
+   for (auto exp : mod.exports) {
+      if (exp->kind == ExternalKind::Func)
+         remap_func(exp->var);
+      else if (exp->kind == ExternalKind::Global)
+         remap_global(exp->var);
+   }
+   for (auto start : mod.starts)
+      remap_func(*start);
+
+   // names would still resolve to the old indices
+   mod.func_bindings.clear();
+   mod.global_bindings.clear();
+   mod.funcs   = std::move(funcs);
+   mod.globals = std::move(globals);
+   mod.imports = std::move(imports);
+   mod.num_func_imports   = num_func_imports;
+   mod.num_global_imports = num_global_imports;
+   return removed;
+}
+
 void AddHeapPointerData( Module& mod, size_t fixup, const std::vector<uint8_t>& buff, DataSegment& ds ) {
    uint32_t heap_ptr  = ((GetHeapPtr(mod, buff)) + 7) & ~7; // align to 8 bytes
    Const c;
@@ -184,63 +447,74 @@ void AddHeapPointerData( Module& mod, size_t fixup, const std::vector<uint8_t>&
    mod.data_segments.push_back(&ds);
 }
 
-void WriteBufferToFile(string_view filename,
-                       const OutputBuffer& buffer) {
-  buffer.WriteToFile(filename);
-}
-
-int ProgramMain(int argc, char** argv) {
-  Result result;
+}  // namespace
 
-  InitStdio();
-  ParseOptions(argc, argv);
+namespace wabt {
 
-  std::vector<uint8_t> file_data;
-  bool stub = false;
-  std::unique_ptr<FileStream> s_log_stream_s;
-  result = ReadFile(s_infile.c_str(), &file_data);
+bool PostProcessModule(const std::vector<uint8_t>& file_data,
+                       const PostPassOptions& pp_options,
+                       std::vector<uint8_t>* output) {
+  std::ostream* report = pp_options.report;
+  Features features;
+  WriteBinaryOptions write_binary_options;
   DataSegment _hds;
-  if (Succeeded(result)) {
-    ErrorHandlerFile error_handler(Location::Type::Binary);
-    Module module;
-    const bool kStopOnFirstError = true;
-    ReadBinaryOptions options(s_features, s_log_stream_s.get(),
-                              stub, kStopOnFirstError,
-                              stub);
-    result = ReadBinaryIr(s_infile.c_str(), file_data.data(),
-                          file_data.size(), &options, &error_handler, &module);
-
-    if (Succeeded(result)) {
-      size_t fixup = 0;
-      auto pre_memory =  FillFromSegments(module.data_segments);
-      auto segments   = CreateSegments(pre_memory);
-      if (pre_memory != FillFromSegments(segments)) {
-        std::cerr << "Fractured Memory Failed, not applying optimizations" << std::endl;
-        module.data_segments = StripZeroedData(std::move(module.data_segments), fixup);
-      } else {
-        module.data_segments = StripZeroedData(std::move(segments), fixup);
-      }
-      AddHeapPointerData(module, fixup, file_data, _hds);
-     if (Succeeded(result)) {
-      MemoryStream stream(s_log_stream.get());
-      result =
-          WriteBinaryModule(&stream, &module, &s_write_binary_options);
-
-      if (Succeeded(result)) {
-        if (s_outfile.empty()) {
-          s_outfile = s_infile;
-        }
-        WriteBufferToFile(s_outfile.c_str(), stream.output_buffer());
-      }
-    }
-   }
+  ErrorHandlerFile error_handler(Location::Type::Binary);
+  Module module;
+  const bool kStopOnFirstError = true;
+  ReadBinaryOptions options(features, nullptr, false, kStopOnFirstError,
+                            false);
+  Result result = ReadBinaryIr(pp_options.filename.c_str(), file_data.data(),
+                               file_data.size(), &options, &error_handler,
+                               &module);
+  if (Failed(result))
+    return false;
 
+  size_t fixup = 0;
+  const std::size_t pre_segments = module.data_segments.size();
+  const std::size_t pre_size = EncodedSize(module.data_segments);
+  if (!module.data_segments.empty()) {
+    auto memory     = FillFromSegments(module.data_segments);
+    auto segments   = CreateSegments(memory, pp_options.max_segments);
+    // trailing zeros are not covered by any segment
+    auto post_memory = FillFromSegments(segments);
+    post_memory.resize(memory.size());
+    if (memory != post_memory) {
+      std::cerr << "Fractured Memory Failed, not applying optimizations" << std::endl;
+      module.data_segments = StripZeroedData(std::move(module.data_segments), fixup);
+    } else {
+      module.data_segments = StripZeroedData(std::move(segments), fixup);
+    }
+  }
+  if (report) {
+    *report << "data segments: " << pre_segments << " -> " << module.data_segments.size() << "\n";
+    *report << "data section bytes: " << pre_size << " -> " << EncodedSize(module.data_segments) << "\n";
+  }
+  AddHeapPointerData(module, fixup, file_data, _hds);
+  if (!pp_options.keep_unreachable) {
+    auto removed = RemoveUnreachable(module);
+    if (report) {
+      *report << "removed functions: " << removed.funcs
+              << ", imports: " << removed.imports << ", globals: " << removed.globals << "\n";
+    }
+  }
+  if (pp_options.optimize) {
+    auto stats = OptimizeModule(&module);
+    if (report) {
+      *report << "folded constants: " << stats.folded_constants
+              << ", removed local ops: " << stats.removed_local_ops
+              << ", flattened blocks: " << stats.flattened_blocks << "\n";
+      *report << "locals: " << stats.locals_before << " -> " << stats.locals_after << "\n";
+    }
   }
-  return result != Result::Ok;
-}
 
-int main(int argc, char** argv) {
-  WABT_TRY
-  return ProgramMain(argc, argv);
-  WABT_CATCH_BAD_ALLOC_AND_EXIT
+  MemoryStream stream(pp_options.log_stream);
+  result = WriteBinaryModule(&stream, &module, &write_binary_options);
+  if (Failed(result))
+    return false;
+  if (report)
+    *report << "module bytes: " << file_data.size() << " -> " << stream.output_buffer().size() << "\n";
+  output->swap(stream.output_buffer().data);
+  return true;
 }
+
+}  // namespace wabt
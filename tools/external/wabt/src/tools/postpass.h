@@ -0,0 +1,53 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WABT_POSTPASS_H_
+#define WABT_POSTPASS_H_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace wabt {
+
+class Stream;
+
+struct PostPassOptions {
+  // name of the module in error messages
+  std::string filename;
+  bool keep_unreachable = false;
+  bool optimize = false;
+  uint32_t max_segments = 1024;
+  // when set, the sizes before and after each pass are printed to it
+  std::ostream* report = nullptr;
+  Stream* log_stream = nullptr;
+};
+
+// The post processing of eosio-pp on a linked module held in memory: strips
+// zeroed data, adds the heap pointer segment, removes unreachable functions,
+// globals and imports and optionally runs the peephole optimizations of
+// postpass-opt.h. Also linked into cdt-ld, which
+// runs it on the output of the linker without starting eosio-pp. Returns
+// false if the module couldn't be read or written, the errors are printed
+// to stderr.
+bool PostProcessModule(const std::vector<uint8_t>& module_data,
+                       const PostPassOptions& options,
+                       std::vector<uint8_t>* output);
+
+}  // namespace wabt
+
+#endif  // WABT_POSTPASS_H_
@@ -0,0 +1,652 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cassert>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+
+#include "src/binary-reader.h"
+#include "src/binary-reader-ir.h"
+#include "src/cast.h"
+#include "src/error-handler.h"
+#include "src/feature.h"
+#include "src/ir.h"
+#include "src/option-parser.h"
+#include "src/stream.h"
+
+using namespace wabt;
+
+static int s_verbose;
+static std::string s_infile;
+static Features s_features;
+static uint32_t s_alloca_bound;
+
+static const char s_description[] =
+R"(  Read a linked contract in the WebAssembly binary format, compute the worst-case
+  stack usage of every exported function and recommend a minimal -stack-size.
+
+  The frame of a function is the deepest constant offset below $__stack_pointer it
+  computes, followed through locals, frames along the call graph are summed and
+  call_indirect is resolved to every table entry with a matching signature.
+  Moving the stack pointer by an amount that isn't a constant makes the stack usage
+  unknown, unless each such dynamic alloca is charged --alloca-bound bytes.
+
+  $ eosio-stack-usage hello.wasm
+)";
+
+static void ParseOptions(int argc, char** argv) {
+  OptionParser parser("eosio-stack-usage", s_description);
+
+  parser.AddOption('v', "verbose", "Print the frame size of every function", []() {
+    s_verbose++;
+  });
+  parser.AddHelpOption();
+  parser.AddOption(
+      'a', "alloca-bound", "BYTES",
+      "Bytes charged for each dynamically sized alloca, by default they are unknown",
+      [](const char* argument) {
+        s_alloca_bound = static_cast<uint32_t>(strtoul(argument, nullptr, 10));
+      });
+  parser.AddArgument("filename", OptionParser::ArgumentCount::One,
+                     [](const char* argument) {
+                       s_infile = argument;
+                       ConvertBackslashToSlash(&s_infile);
+                     });
+  parser.Parse(argc, argv);
+}
+
+// worst case of a call graph containing recursion
+static constexpr uint64_t kUnbounded = UINT64_MAX;
+// worst case of a frame adjusted by an amount that isn't a constant
+static constexpr uint64_t kUnknown = UINT64_MAX - 1;
+
+struct FuncInfo {
+  uint64_t frame = 0;
+  // sites subtracting a non-constant amount from a stack pointer value
+  std::set<const Expr*> dynamic_allocas;
+  // the stack pointer is set to a value that can't be tracked back to its entry
+  // value, e.g. loaded from memory or moved on every loop iteration
+  bool untracked_sp = false;
+  std::set<Index> callees;
+  std::set<Index> indirect_types;
+
+  uint64_t Bound() const {
+    if (untracked_sp || (!dynamic_allocas.empty() && !s_alloca_bound))
+      return kUnknown;
+    return frame + static_cast<uint64_t>(dynamic_allocas.size()) * s_alloca_bound;
+  }
+};
+
+// Value of the frame analysis, tracking what is derived from the stack pointer
+// the function was entered with
+struct SpValue {
+  enum class Kind {
+    Unknown,
+    Const,     // i32 constant `value`
+    Sp,        // the entry stack pointer minus `value` bytes
+    SpIndexed, // an address above a Sp value, e.g. an element of a frame array
+    SpDynamic, // the entry stack pointer minus an amount that isn't a constant
+  };
+
+  static SpValue Unknown() { return {Kind::Unknown, 0}; }
+  static SpValue Const(int64_t v) { return {Kind::Const, v}; }
+  static SpValue Sp(int64_t below) { return {Kind::Sp, below}; }
+  static SpValue Indexed() { return {Kind::SpIndexed, 0}; }
+  static SpValue Dynamic() { return {Kind::SpDynamic, 0}; }
+
+  bool IsSpDerived() const {
+    return kind == Kind::Sp || kind == Kind::SpIndexed || kind == Kind::SpDynamic;
+  }
+  bool operator==(const SpValue& o) const { return kind == o.kind && value == o.value; }
+  bool operator!=(const SpValue& o) const { return !(*this == o); }
+
+  Kind kind;
+  int64_t value;
+};
+
+// Value on either of two paths, stack pointers are merged to the deeper one
+inline SpValue Merge(const SpValue& a, const SpValue& b) {
+  if (a == b)
+    return a;
+  if (a.kind == SpValue::Kind::Sp && b.kind == SpValue::Kind::Sp)
+    return SpValue::Sp(std::max(a.value, b.value));
+  if (a.kind == SpValue::Kind::SpDynamic || b.kind == SpValue::Kind::SpDynamic)
+    return SpValue::Dynamic();
+  if (a.IsSpDerived() && b.IsSpDerived())
+    return SpValue::Indexed();
+  return SpValue::Unknown();
+}
+
+struct FrameState {
+  std::vector<SpValue> locals;
+  SpValue sp;
+
+  bool operator==(const FrameState& o) const { return sp == o.sp && locals == o.locals; }
+  bool operator!=(const FrameState& o) const { return !(*this == o); }
+};
+
+inline void Merge(FrameState& into, const FrameState& from) {
+  into.sp = Merge(into.sp, from.sp);
+  for (size_t i = 0; i < into.locals.size(); ++i)
+    into.locals[i] = Merge(into.locals[i], from.locals[i]);
+}
+
+// Computes the frame of a function by following the stack pointer (global 0,
+// the global eosio-pp reads the initial stack pointer from) through the locals
+// and the value stack. The frame is the deepest constant offset below the entry
+// stack pointer the function computes, whether or not it is written back, as
+// leaf functions address their frame without updating the global. Subtracting
+// anything but a constant from a stack pointer value is a dynamic alloca.
+class FrameAnalysis {
+ public:
+  FrameAnalysis(const Module& mod, const Func& func, FuncInfo& info)
+      : mod_(mod), func_(func), info_(info) {}
+
+  void Run() {
+    state_.sp = SpValue::Sp(0);
+    for (Index i = 0; i < func_.GetNumParamsAndLocals(); ++i)
+      state_.locals.push_back(i < func_.GetNumParams() ? SpValue::Unknown()
+                                                       : SpValue::Const(0));
+    labels_.push_back({});
+    AnalyzeExprs(func_.exprs);
+    labels_.pop_back();
+  }
+
+ private:
+  struct Label {
+    // states at the branches to the label
+    std::vector<FrameState> branches;
+  };
+
+  SpValue Pop() {
+    if (stack_.empty())
+      return SpValue::Unknown();
+    SpValue v = stack_.back();
+    stack_.pop_back();
+    return v;
+  }
+
+  void Push(const SpValue& v) {
+    if (v.kind == SpValue::Kind::Sp && v.value > 0)
+      info_.frame = std::max<uint64_t>(info_.frame, v.value);
+    stack_.push_back(v);
+  }
+
+  void PopPush(Index pops, Index pushes) {
+    for (Index i = 0; i < pops; ++i)
+      Pop();
+    for (Index i = 0; i < pushes; ++i)
+      Push(SpValue::Unknown());
+  }
+
+  void SetUnreachable() {
+    reachable_ = false;
+    stack_.clear();
+  }
+
+  void Branch(const Var& depth) {
+    if (reachable_ && depth.is_index() && depth.index() < labels_.size())
+      labels_[labels_.size() - 1 - depth.index()].branches.push_back(state_);
+  }
+
+  SpValue Sub(const Expr* expr, const SpValue& a, const SpValue& b) {
+    using Kind = SpValue::Kind;
+    if (a.kind == Kind::Const && b.kind == Kind::Const)
+      return SpValue::Const(static_cast<int32_t>(a.value - b.value));
+    if (!a.IsSpDerived())
+      return SpValue::Unknown();
+    // the distance between two addresses
+    if (b.IsSpDerived())
+      return SpValue::Unknown();
+    if (b.kind != Kind::Const) {
+      if (a.kind != Kind::SpDynamic)
+        info_.dynamic_allocas.insert(expr);
+      return SpValue::Dynamic();
+    }
+    if (a.kind == Kind::Sp)
+      return SpValue::Sp(a.value + static_cast<int32_t>(b.value));
+    return a;
+  }
+
+  SpValue Add(const SpValue& a, const SpValue& b) {
+    using Kind = SpValue::Kind;
+    if (a.kind == Kind::Const && b.kind == Kind::Const)
+      return SpValue::Const(static_cast<int32_t>(a.value + b.value));
+    if (a.IsSpDerived() && b.IsSpDerived())
+      return SpValue::Unknown();
+    const SpValue& sp = a.IsSpDerived() ? a : b;
+    const SpValue& other = a.IsSpDerived() ? b : a;
+    if (!sp.IsSpDerived())
+      return SpValue::Unknown();
+    if (sp.kind == Kind::Sp)
+      return other.kind == Kind::Const ? SpValue::Sp(sp.value - static_cast<int32_t>(other.value))
+                                       : SpValue::Indexed();
+    return sp;
+  }
+
+  SpValue And(const SpValue& a, const SpValue& b) {
+    using Kind = SpValue::Kind;
+    if (a.kind == Kind::Const && b.kind == Kind::Const)
+      return SpValue::Const(static_cast<int32_t>(a.value & b.value));
+    const SpValue& sp = a.IsSpDerived() ? a : b;
+    const SpValue& mask = a.IsSpDerived() ? b : a;
+    if (!sp.IsSpDerived() || mask.kind != Kind::Const)
+      return SpValue::Unknown();
+    // aligning down by a power of two moves the address at most `~mask` bytes lower
+    uint32_t low = ~static_cast<uint32_t>(mask.value);
+    if (low & (low + 1))
+      return SpValue::Unknown();
+    if (sp.kind == Kind::Sp)
+      return SpValue::Sp(sp.value + low);
+    return sp;
+  }
+
+  void AnalyzeBinary(const BinaryExpr* bin) {
+    SpValue b = Pop();
+    SpValue a = Pop();
+    switch (bin->opcode) {
+      case Opcode::I32Sub: Push(Sub(bin, a, b)); break;
+      case Opcode::I32Add: Push(Add(a, b)); break;
+      case Opcode::I32And: Push(And(a, b)); break;
+      default: Push(SpValue::Unknown()); break;
+    }
+  }
+
+  // Analyzes a block, loop or if body with its own value stack, the stack
+  // below it is restored afterwards with the results of the block pushed
+  void AnalyzeBody(const ExprList& exprs, const BlockDeclaration& decl) {
+    std::vector<SpValue> outer = std::move(stack_);
+    stack_.clear();
+    labels_.push_back({});
+    AnalyzeExprs(exprs);
+    Label done = std::move(labels_.back());
+    labels_.pop_back();
+
+    std::vector<SpValue> results(decl.GetNumResults(), SpValue::Unknown());
+    if (reachable_ && done.branches.empty() && stack_.size() >= results.size())
+      std::copy(stack_.end() - results.size(), stack_.end(), results.begin());
+    for (const FrameState& branch : done.branches) {
+      if (reachable_)
+        Merge(state_, branch);
+      else
+        state_ = branch;
+      reachable_ = true;
+    }
+    stack_ = std::move(outer);
+    for (const SpValue& v : results)
+      Push(v);
+  }
+
+  void AnalyzeLoop(const Block& block) {
+    // run the body again from the states branching back to the loop until they
+    // stop changing. Locals still changing after two passes walk over the frame,
+    // they are widened to addresses within it. A stack pointer still changing
+    // moves on every iteration, which can't be bounded.
+    FrameState entry = state_;
+    for (int pass = 0;; ++pass) {
+      state_ = entry;
+      reachable_ = true;
+      std::vector<SpValue> outer = std::move(stack_);
+      stack_.clear();
+      labels_.push_back({});
+      AnalyzeExprs(block.exprs);
+      Label done = std::move(labels_.back());
+      labels_.pop_back();
+      stack_ = std::move(outer);
+
+      FrameState next = entry;
+      for (const FrameState& branch : done.branches)
+        Merge(next, branch);
+      if (next == entry)
+        break;
+      if (pass == 2) {
+        info_.untracked_sp = true;
+        break;
+      }
+      if (pass == 1) {
+        for (size_t i = 0; i < next.locals.size(); ++i) {
+          if (next.locals[i] != entry.locals[i] && next.locals[i].IsSpDerived() &&
+              next.locals[i].kind != SpValue::Kind::SpDynamic)
+            next.locals[i] = SpValue::Indexed();
+        }
+      }
+      entry = next;
+    }
+    for (Index i = 0; i < block.decl.GetNumResults(); ++i)
+      Push(SpValue::Unknown());
+  }
+
+  void AnalyzeIf(const IfExpr* if_) {
+    Pop();
+    FrameState entry = state_;
+    AnalyzeBody(if_->true_.exprs, if_->true_.decl);
+    FrameState after_true = state_;
+    bool true_reachable = reachable_;
+    PopPush(if_->true_.decl.GetNumResults(), 0);
+
+    state_ = entry;
+    reachable_ = true;
+    AnalyzeBody(if_->false_, if_->true_.decl);
+    if (true_reachable) {
+      if (reachable_)
+        Merge(state_, after_true);
+      else
+        state_ = after_true;
+      reachable_ = true;
+    }
+  }
+
+  void SetSp(const SpValue& v) {
+    state_.sp = v;
+    if (!reachable_)
+      return;
+    if (v.kind == SpValue::Kind::Unknown || v.kind == SpValue::Kind::Const ||
+        v.kind == SpValue::Kind::SpIndexed)
+      info_.untracked_sp = true;
+  }
+
+  void AnalyzeExprs(const ExprList& exprs) {
+    for (const Expr& expr : exprs)
+      Analyze(&expr);
+  }
+
+  void Analyze(const Expr* expr) {
+    switch (expr->type()) {
+      case ExprType::Binary:
+        AnalyzeBinary(cast<BinaryExpr>(expr));
+        break;
+      case ExprType::Const: {
+        auto c = cast<ConstExpr>(expr);
+        Push(c->const_.type == Type::I32
+                 ? SpValue::Const(static_cast<int32_t>(c->const_.u32))
+                 : SpValue::Unknown());
+        break;
+      }
+      case ExprType::GetGlobal: {
+        const Var& var = cast<GetGlobalExpr>(expr)->var;
+        Push(mod_.GetGlobalIndex(var) == 0 ? state_.sp : SpValue::Unknown());
+        break;
+      }
+      case ExprType::SetGlobal: {
+        SpValue v = Pop();
+        if (mod_.GetGlobalIndex(cast<SetGlobalExpr>(expr)->var) == 0)
+          SetSp(v);
+        break;
+      }
+      case ExprType::GetLocal: {
+        Index index = func_.GetLocalIndex(cast<GetLocalExpr>(expr)->var);
+        Push(index < state_.locals.size() ? state_.locals[index] : SpValue::Unknown());
+        break;
+      }
+      case ExprType::SetLocal:
+      case ExprType::TeeLocal: {
+        const Var& var = expr->type() == ExprType::SetLocal
+                             ? cast<SetLocalExpr>(expr)->var
+                             : cast<TeeLocalExpr>(expr)->var;
+        Index index = func_.GetLocalIndex(var);
+        SpValue v = Pop();
+        if (index < state_.locals.size())
+          state_.locals[index] = v;
+        if (expr->type() == ExprType::TeeLocal)
+          Push(v);
+        break;
+      }
+      case ExprType::Select: {
+        Pop();
+        SpValue b = Pop();
+        SpValue a = Pop();
+        Push(Merge(a, b));
+        break;
+      }
+      case ExprType::Call: {
+        Index callee = mod_.GetFuncIndex(cast<CallExpr>(expr)->var);
+        info_.callees.insert(callee);
+        const Func* func = mod_.GetFunc(cast<CallExpr>(expr)->var);
+        PopPush(func ? func->GetNumParams() : 0, func ? func->GetNumResults() : 0);
+        break;
+      }
+      case ExprType::CallIndirect: {
+        auto call = cast<CallIndirectExpr>(expr);
+        info_.indirect_types.insert(mod_.GetFuncTypeIndex(call->decl));
+        PopPush(call->decl.GetNumParams() + 1, call->decl.GetNumResults());
+        break;
+      }
+      case ExprType::Block: {
+        auto block = cast<BlockExpr>(expr);
+        AnalyzeBody(block->block.exprs, block->block.decl);
+        break;
+      }
+      case ExprType::Loop:
+        AnalyzeLoop(cast<LoopExpr>(expr)->block);
+        break;
+      case ExprType::If:
+        AnalyzeIf(cast<IfExpr>(expr));
+        break;
+      case ExprType::Br:
+        Branch(cast<BrExpr>(expr)->var);
+        SetUnreachable();
+        break;
+      case ExprType::BrIf:
+        Pop();
+        Branch(cast<BrIfExpr>(expr)->var);
+        break;
+      case ExprType::BrTable: {
+        auto table = cast<BrTableExpr>(expr);
+        Pop();
+        for (const Var& target : table->targets)
+          Branch(target);
+        Branch(table->default_target);
+        SetUnreachable();
+        break;
+      }
+      case ExprType::Return:
+      case ExprType::Unreachable:
+        SetUnreachable();
+        break;
+      case ExprType::Drop:           PopPush(1, 0); break;
+      case ExprType::Nop:            break;
+      case ExprType::Compare:        PopPush(2, 1); break;
+      case ExprType::Convert:
+      case ExprType::Unary:
+      case ExprType::Load:
+      case ExprType::AtomicLoad:
+      case ExprType::MemoryGrow:     PopPush(1, 1); break;
+      case ExprType::MemorySize:     PopPush(0, 1); break;
+      case ExprType::Store:
+      case ExprType::AtomicStore:    PopPush(2, 0); break;
+      case ExprType::AtomicRmw:
+      case ExprType::AtomicWake:     PopPush(2, 1); break;
+      case ExprType::AtomicRmwCmpxchg:
+      case ExprType::AtomicWait:
+      case ExprType::Ternary:        PopPush(3, 1); break;
+      default:
+        // SIMD and exception handling are not accepted by nodeos, give up on the frame
+        info_.untracked_sp = true;
+        stack_.clear();
+        break;
+    }
+  }
+
+  const Module& mod_;
+  const Func& func_;
+  FuncInfo& info_;
+  FrameState state_;
+  bool reachable_ = true;
+  std::vector<SpValue> stack_;
+  std::vector<Label> labels_;
+};
+
+class StackAnalysis {
+ public:
+  explicit StackAnalysis(const Module& mod) : mod_(mod) {
+    infos_.resize(mod.funcs.size());
+    for (Index i = mod.num_func_imports; i < mod.funcs.size(); ++i) {
+      FrameAnalysis(mod, *mod.funcs[i], infos_[i]).Run();
+    }
+
+    for (const ElemSegment* seg : mod.elem_segments) {
+      for (const Var& var : seg->vars)
+        table_funcs_.insert(mod.GetFuncIndex(var));
+    }
+    worst_.assign(mod.funcs.size(), 0);
+    state_.assign(mod.funcs.size(), State::Unvisited);
+  }
+
+  const FuncInfo& Info(Index func_index) const { return infos_[func_index]; }
+
+  // worst case stack consumed by a call to `func_index`, kUnbounded on recursion
+  // and kUnknown when a frame along the call graph can't be sized
+  uint64_t WorstCase(Index func_index) {
+    if (func_index < mod_.num_func_imports)
+      return 0;
+    if (state_[func_index] == State::Done)
+      return worst_[func_index];
+    if (state_[func_index] == State::InProgress) {
+      recursive_.insert(func_index);
+      return kUnbounded;
+    }
+
+    state_[func_index] = State::InProgress;
+    const FuncInfo& info = infos_[func_index];
+    uint64_t deepest = 0;
+    auto visit = [&](Index callee) { deepest = std::max(deepest, WorstCase(callee)); };
+    for (Index callee : info.callees)
+      visit(callee);
+    for (Index callee : table_funcs_) {
+      if (info.indirect_types.count(mod_.GetFuncTypeIndex(mod_.funcs[callee]->decl)))
+        visit(callee);
+    }
+
+    state_[func_index] = State::Done;
+    uint64_t frame = info.Bound();
+    worst_[func_index] = std::max(frame, deepest) >= kUnknown ? std::max(frame, deepest)
+                                                              : frame + deepest;
+    return worst_[func_index];
+  }
+
+  const std::set<Index>& Recursive() const { return recursive_; }
+
+ private:
+  enum class State { Unvisited, InProgress, Done };
+
+  const Module& mod_;
+  std::vector<FuncInfo> infos_;
+  std::vector<uint64_t> worst_;
+  std::vector<State> state_;
+  std::set<Index> table_funcs_;
+  std::set<Index> recursive_;
+};
+
+std::string FuncName(const Module& mod, Index func_index) {
+  const std::string& name = mod.funcs[func_index]->name;
+  if (!name.empty())
+    return name;
+  return "func[" + std::to_string(func_index) + "]";
+}
+
+uint32_t GetInitialStackPtr(const Module& mod) {
+  if (mod.globals.empty() || mod.globals[0]->init_expr.empty())
+    return 0;
+  auto c = dyn_cast<ConstExpr>(&mod.globals[0]->init_expr.front());
+  return c ? c->const_.u32 : 0;
+}
+
+int ProgramMain(int argc, char** argv) {
+  Result result;
+
+  InitStdio();
+  ParseOptions(argc, argv);
+
+  std::vector<uint8_t> file_data;
+  result = ReadFile(s_infile.c_str(), &file_data);
+  if (Succeeded(result)) {
+    ErrorHandlerFile error_handler(Location::Type::Binary);
+    Module module;
+    const bool kReadDebugNames = true;
+    const bool kStopOnFirstError = true;
+    const bool kFailOnCustomSectionError = false;
+    ReadBinaryOptions options(s_features, nullptr, kReadDebugNames,
+                              kStopOnFirstError, kFailOnCustomSectionError);
+    result = ReadBinaryIr(s_infile.c_str(), file_data.data(),
+                          file_data.size(), &options, &error_handler, &module);
+
+    if (Succeeded(result)) {
+      StackAnalysis analysis(module);
+
+      if (s_verbose) {
+        for (Index i = module.num_func_imports; i < module.funcs.size(); ++i) {
+          const FuncInfo& info = analysis.Info(i);
+          std::cout << "frame " << FuncName(module, i) << ": ";
+          if (info.Bound() == kUnknown)
+            std::cout << "unknown";
+          else
+            std::cout << info.Bound();
+          if (!info.dynamic_allocas.empty())
+            std::cout << " (" << info.dynamic_allocas.size() << " dynamic alloca)";
+          std::cout << "\n";
+        }
+      }
+
+      uint64_t required = 0;
+      for (const Export* exp : module.exports) {
+        if (exp->kind != ExternalKind::Func)
+          continue;
+        uint64_t worst = analysis.WorstCase(module.GetFuncIndex(exp->var));
+        std::cout << exp->name << ": ";
+        if (worst == kUnbounded)
+          std::cout << "unbounded (recursive)\n";
+        else if (worst == kUnknown)
+          std::cout << "unknown\n";
+        else
+          std::cout << worst << " bytes\n";
+        required = std::max(required, worst);
+      }
+
+      for (Index i : analysis.Recursive())
+        std::cout << "warning: " << FuncName(module, i)
+                  << " is recursive, its stack usage cannot be bounded\n";
+      for (Index i = module.num_func_imports; i < module.funcs.size(); ++i) {
+        const FuncInfo& info = analysis.Info(i);
+        if (info.untracked_sp)
+          std::cout << "warning: " << FuncName(module, i)
+                    << " sets the stack pointer to a value that can't be tracked\n";
+        else if (!info.dynamic_allocas.empty() && !s_alloca_bound)
+          std::cout << "warning: " << FuncName(module, i)
+                    << " moves the stack pointer by an amount that isn't a constant,"
+                       " bound it with --alloca-bound\n";
+      }
+
+      uint32_t configured = GetInitialStackPtr(module);
+      if (configured)
+        std::cout << "initial stack pointer: " << configured << "\n";
+      if (required < kUnknown) {
+        // wasm-ld requires the stack size to be 16 byte aligned
+        uint64_t recommended = std::max<uint64_t>((required + 15) & ~uint64_t(15), 16);
+        std::cout << "recommended: -stack-size=" << recommended << "\n";
+      }
+    }
+  }
+  return result != Result::Ok;
+}
+
+int main(int argc, char** argv) {
+  WABT_TRY
+  return ProgramMain(argc, argv);
+  WABT_CATCH_BAD_ALLOC_AND_EXIT
+}
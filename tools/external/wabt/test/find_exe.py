@@ -28,6 +28,10 @@ EXECUTABLES = [
     'wasm-opcodecnt', 'wat-desugar', 'spectest-interp', 'wasm-validate',
     'wasm2c',
 ]
+# the tools built for CDT, the wabt tools above are not all built with it
+EOSIO_EXECUTABLES = [
+    'eosio-wast2wasm', 'eosio-wasm2wast', 'eosio-pp', 'eosio-stack-usage',
+]
 
 GEN_WASM_PY = os.path.join(SCRIPT_DIR, 'gen-wasm.py')
 GEN_SPEC_JS_PY = os.path.join(SCRIPT_DIR, 'gen-spec-js.py')
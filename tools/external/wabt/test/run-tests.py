@@ -132,7 +132,18 @@ TOOLS = {
                 '%(out_dir)s',
                 ]),
         ('VERBOSE-ARGS', ['--print-cmd', '-v']),
-    ]
+    ],
+    'run-eosio-pp': [
+        ('RUN', '%(eosio-wast2wasm)s %(in_file)s -o %(temp_file)s.wasm'),
+        ('RUN', '%(eosio-pp)s %(temp_file)s.wasm -o %(temp_file)s.pp.wasm'),
+        ('RUN', '%(eosio-wasm2wast)s %(temp_file)s.pp.wasm'),
+        ('VERBOSE-ARGS', ['--print-cmd', '-v']),
+    ],
+    'run-eosio-stack-usage': [
+        ('RUN', '%(eosio-wast2wasm)s %(in_file)s -o %(temp_file)s.wasm'),
+        ('RUN', '%(eosio-stack-usage)s %(temp_file)s.wasm'),
+        ('VERBOSE-ARGS', ['--print-cmd', '-v']),
+    ],
 }
 
 # TODO(binji): Add Windows support for compiling using run-spec-wasm2c.py
@@ -550,7 +561,7 @@ class TestInfo(object):
 
   def Rebase(self, stdout, stderr):
     test_path = os.path.join(REPO_ROOT_DIR, self.filename)
-    with open(test_path, 'wb') as f:
+    with open(test_path, 'w') as f:
       f.write(self.header)
       f.write(self.input_)
       if stderr:
@@ -695,7 +706,10 @@ def RunTest(info, options, variables, verbose_level=0):
   test_result = TestResult()
 
   for cmd_template in info.cmds:
-    cmd = cmd_template.GetCommand(variables, options.arg, verbose_level)
+    try:
+      cmd = cmd_template.GetCommand(variables, options.arg, verbose_level)
+    except KeyError as e:
+      return Error('%s executable not found in %s' % (e, options.bindir))
     if options.print_cmd:
       print(cmd)
 
@@ -833,6 +847,7 @@ def GetDefaultJobCount():
 
 
 def main(args):
+  global OUT_DIR
   parser = argparse.ArgumentParser()
   parser.add_argument('-a', '--arg',
                       help='additional args to pass to executable',
@@ -840,6 +855,8 @@ def main(args):
   parser.add_argument('--bindir', metavar='PATH',
                       default=find_exe.GetDefaultPath(),
                       help='directory to search for all executables.')
+  parser.add_argument('--out-dir', metavar='PATH', default=OUT_DIR,
+                      help='directory to write the test outputs to.')
   parser.add_argument('-v', '--verbose', help='print more diagnotic messages.',
                       action='store_true')
   parser.add_argument('-f', '--fail-fast', help='Exit on first failure. '
@@ -866,6 +883,7 @@ def main(args):
   parser.add_argument('patterns', metavar='pattern', nargs='*',
                       help='test patterns.')
   options = parser.parse_args(args)
+  OUT_DIR = os.path.abspath(options.out_dir)
 
   if options.jobs != 1:
     if options.fail_fast:
@@ -894,10 +912,14 @@ def main(args):
   variables['bindir'] = options.bindir
   variables['gen_wasm_py'] = find_exe.GEN_WASM_PY
   variables['gen_spec_js_py'] = find_exe.GEN_SPEC_JS_PY
-  for exe_basename in find_exe.EXECUTABLES:
+  for exe_basename in find_exe.EXECUTABLES + find_exe.EOSIO_EXECUTABLES:
     exe_override = os.path.join(options.bindir, exe_basename)
-    variables[exe_basename] = find_exe.FindExecutable(exe_basename,
-                                                      exe_override)
+    try:
+      variables[exe_basename] = find_exe.FindExecutable(exe_basename,
+                                                        exe_override)
+    except Error:
+      # only the tests running a missing executable fail
+      pass
 
   status = Status(sys.stderr.isatty() and not options.verbose)
   infos = GetAllTestInfo(test_names, status)
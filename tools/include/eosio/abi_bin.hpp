@@ -0,0 +1,122 @@
+#pragma once
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wnon-virtual-dtor"
+#pragma GCC diagnostic ignored "-Wcovered-switch-default"
+#include <jsoncons/json.hpp>
+#pragma GCC diagnostic pop
+
+#include <eosio/utils.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace eosio { namespace cdt {
+
+   // Serializes a JSON ABI into the binary `abi_def` layout nodes store, the payload of `setabi`.
+   // It is written from the ABI the linker merged from every object, so it describes the same contract
+   // as the .abi file. Field order follows eosio libraries/chain/include/eosio/chain/abi_def.hpp; the
+   // trailing sections are `may_not_exist` extensions, `calls` is only written when the ABI has them.
+   class abi_bin_writer {
+      public:
+         std::vector<char> to_bin(const jsoncons::ojson& abi) {
+            bin.clear();
+            write(abi["version"].as<std::string>());
+            write_array(abi, "types", [&](const jsoncons::ojson& t) {
+               write(t["new_type_name"].as<std::string>());
+               write(t["type"].as<std::string>());
+            });
+            write_array(abi, "structs", [&](const jsoncons::ojson& s) {
+               write(s["name"].as<std::string>());
+               write(s["base"].as<std::string>());
+               write_array(s, "fields", [&](const jsoncons::ojson& f) {
+                  write(f["name"].as<std::string>());
+                  write(f["type"].as<std::string>());
+               });
+            });
+            write_array(abi, "actions", [&](const jsoncons::ojson& act) {
+               write_name(act["name"].as<std::string>());
+               write(act["type"].as<std::string>());
+               write(act["ricardian_contract"].as<std::string>());
+            });
+            write_array(abi, "tables", [&](const jsoncons::ojson& t) {
+               write_name(t["name"].as<std::string>());
+               write(t["index_type"].as<std::string>());
+               write_array(t, "key_names", [&](const jsoncons::ojson& k) { write(k.as<std::string>()); });
+               write_array(t, "key_types", [&](const jsoncons::ojson& k) { write(k.as<std::string>()); });
+               write(t["type"].as<std::string>());
+            });
+            write_array(abi, "ricardian_clauses", [&](const jsoncons::ojson& rc) {
+               write(rc["id"].as<std::string>());
+               write(rc["body"].as<std::string>());
+            });
+            write_array(abi, "error_messages", [&](const jsoncons::ojson& em) {
+               write(em["error_code"].as<uint64_t>());
+               write(em["error_msg"].as<std::string>());
+            });
+            // abigen doesn't emit ABI extensions
+            if (abi.has_key("abi_extensions") && !abi["abi_extensions"].empty())
+               throw std::runtime_error("ABI extensions can't be written in binary form");
+            write_varuint(0);
+            write_array(abi, "variants", [&](const jsoncons::ojson& v) {
+               write(v["name"].as<std::string>());
+               write_array(v, "types", [&](const jsoncons::ojson& t) { write(t.as<std::string>()); });
+            });
+            write_array(abi, "action_results", [&](const jsoncons::ojson& ar) {
+               write_name(ar["name"].as<std::string>());
+               write(ar["result_type"].as<std::string>());
+            });
+            if (abi.has_key("calls") && !abi["calls"].empty()) {
+               write_array(abi, "calls", [&](const jsoncons::ojson& c) {
+                  write(c["name"].as<std::string>());
+                  write(c["type"].as<std::string>());
+                  write(c["id"].as<uint64_t>());
+                  write(c["result_type"].as<std::string>());
+               });
+            }
+            return std::move(bin);
+         }
+
+      private:
+         std::vector<char> bin;
+
+         void write_varuint(uint64_t v) {
+            do {
+               uint8_t b = v & 0x7f;
+               v >>= 7;
+               b |= (v > 0) << 7;
+               bin.push_back(static_cast<char>(b));
+            } while (v);
+         }
+
+         void write(uint64_t v) {
+            for (int i = 0; i < 8; i++)
+               bin.push_back(static_cast<char>(v >> (8 * i)));
+         }
+
+         void write(const std::string& s) {
+            write_varuint(s.size());
+            bin.insert(bin.end(), s.begin(), s.end());
+         }
+
+         void write_name(const std::string& n) { write(string_to_name(n.c_str())); }
+
+         // a section missing from the JSON is written empty
+         template <typename F>
+         void write_array(const jsoncons::ojson& parent, const char* key, F&& write_element) {
+            if (!parent.has_key(key)) {
+               write_varuint(0);
+               return;
+            }
+            const auto& elements = parent[key];
+            write_varuint(elements.size());
+            for (const auto& e : elements.array_range())
+               write_element(e);
+         }
+   };
+
+   inline std::vector<char> abi_to_bin(const jsoncons::ojson& abi) {
+      return abi_bin_writer{}.to_bin(abi);
+   }
+}} // ns eosio::cdt
@@ -120,7 +120,7 @@ namespace eosio::cdt {
          ret.type = decl->getNameAsString();
          _abi.actions.insert(ret);
          // TODO
-         if (translate_type(decl->getReturnType()) != "void") {
+         if (!decl->getReturnType()->isVoidType()) {
             /** TODO after LLVM 9 update uncomment this code and use new error handling for pretty clang style errors
             if (decl->getReturnType() == decl->getDeclaredReturnType())
             */
@@ -169,10 +169,9 @@ namespace eosio::cdt {
          }
          ret.type = decl->getNameAsString();
          ret.id = to_hash_id(ret.name);
-         auto result_type = translate_type(decl->getReturnType());
-         if (result_type != "void") {
+         if (!decl->getReturnType()->isVoidType()) {
             add_type(decl->getReturnType());
-            ret.result_type = result_type;
+            ret.result_type = translate_type(decl->getReturnType());
          }
          _abi.calls.insert(ret);
 
@@ -661,13 +660,14 @@ namespace eosio::cdt {
          return _abi.structs.empty() && _abi.typedefs.empty() && _abi.actions.empty() && _abi.calls.empty()  && set_of_tables.empty() && _abi.ricardian_clauses.empty() && _abi.variants.empty();
       }
 
-      ojson to_json() {
-         ojson o;
-         o["____comment"] = generate_json_comment();
+      // The ABI as it is emitted: only the structs and types in use, and the tables
+      // of both the `[[eosio::table]]` records and the `multi_index` declarations
+      abi emitted_abi() {
+         abi emitted = _abi;
+         emitted.structs.clear();
+         emitted.typedefs.clear();
+         emitted.tables.clear();
 
-         o["version"]     = _abi.version_string();
-
-         o["structs"]     = ojson::array();
          auto remove_suffix = [&]( std::string name ) {
             int i = name.length()-1;
             for (; i >= 0; i--)
@@ -780,43 +780,60 @@ namespace eosio::cdt {
          };
 
          for ( auto s : _abi.structs ) {
-            const auto res = validate_struct(s);
-            if (res)
-               o["structs"].push_back(struct_to_json(s));
+            if (validate_struct(s))
+               emitted.structs.insert(s);
          }
-         o["types"]       = ojson::array();
          for ( auto t : _abi.typedefs ) {
             if (validate_types(t))
-               o["types"].push_back(typedef_to_json( t ));
+               emitted.typedefs.insert(t);
+         }
+         emitted.tables = set_of_tables;
+         return emitted;
+      }
+
+      ojson to_json() {
+         const abi emitted = emitted_abi();
+         ojson o;
+         o["____comment"] = generate_json_comment();
+
+         o["version"]     = emitted.version_string();
+
+         o["structs"]     = ojson::array();
+         for ( auto s : emitted.structs ) {
+            o["structs"].push_back(struct_to_json(s));
+         }
+         o["types"]       = ojson::array();
+         for ( auto t : emitted.typedefs ) {
+            o["types"].push_back(typedef_to_json( t ));
          }
          o["actions"]     = ojson::array();
-         for ( auto a : _abi.actions ) {
+         for ( auto a : emitted.actions ) {
             o["actions"].push_back(action_to_json( a ));
          }
-         if (!_abi.calls.empty()) {  // add calls section only when sync calls are used
+         if (!emitted.calls.empty()) {  // add calls section only when sync calls are used
             o["calls"] = ojson::array();
-            for ( auto a : _abi.calls ) {
+            for ( auto a : emitted.calls ) {
                o["calls"].push_back(call_to_json( a ));
             }
          }
          o["tables"]     = ojson::array();
-         for ( auto t : set_of_tables ) {
+         for ( auto t : emitted.tables ) {
             o["tables"].push_back(table_to_json( t ));
          }
          o["ricardian_clauses"]  = ojson::array();
-         for ( auto rc : _abi.ricardian_clauses ) {
+         for ( auto rc : emitted.ricardian_clauses ) {
             o["ricardian_clauses"].push_back(clause_to_json( rc ));
          }
 
          o["variants"]   = ojson::array();
-         for ( auto v : _abi.variants ) {
+         for ( auto v : emitted.variants ) {
             o["variants"].push_back(variant_to_json( v ));
          }
 
          o["abi_extensions"]     = ojson::array();
 
          o["action_results"]  = ojson::array();
-         for ( auto ar : _abi.action_results ) {
+         for ( auto ar : emitted.action_results ) {
             o["action_results"].push_back(action_result_to_json( ar ));
          }
          return o;
@@ -990,7 +1007,10 @@ namespace eosio::cdt {
 
       public:
          explicit eosio_abigen_consumer(CompilerInstance *CI, std::string file)
-            : visitor(new eosio_abigen_visitor(CI)), main_file(file), ci(CI) { }
+            : visitor(new eosio_abigen_visitor(CI)), main_file(file), ci(CI) {
+            // cached types are only valid in the ASTContext of the previous translation unit
+            generation_utils::clear_type_cache();
+         }
 
          virtual void HandleTranslationUnit(ASTContext &Context) {
             auto& src_mgr = Context.getSourceManager();
@@ -6,7 +6,10 @@
 #include <jsoncons/json.hpp>
 #include "abi.hpp"
 
+#include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 using jsoncons::json;
@@ -14,18 +17,18 @@ using jsoncons::ojson;
 
 class ABIMerger {
    public:
-      ABIMerger(ojson a) : abi(a) {}
+      ABIMerger(ojson a) : abi(std::move(a)) {}
       void set_abi(ojson a) {
-         abi = a;
+         abi = std::move(a);
       }
       std::string get_abi_string()const {
          std::stringstream ss;
          ss << pretty_print(abi);
          return ss.str();
       }
-      ojson merge(ojson other) {
+      ojson merge(const ojson& other)const {
          ojson ret;
-         ret["____comment"] = abi["____comment"];
+         ret["____comment"] = get(abi, "____comment");
          ret["version"]  = merge_version(other);
          ret["types"]    = merge_types(other);
          ret["structs"]  = merge_structs(other);
@@ -37,180 +40,168 @@ class ABIMerger {
          if (std::stod(vers.substr(vers.size()-3))*10 >= 12) {
             ret["action_results"] = merge_action_results(other);
          }
-         auto it = abi.find("calls");
-         if (it != abi.object_range().end()) { // merge `calls` section only when it exists
+         if (abi.has_key("calls")) { // merge `calls` section only when it exists
             ret["calls"] = merge_calls(other);
          }
          return ret;
       }
    private:
-      std::string merge_version(ojson b) {
+      std::string merge_version(const ojson& b)const {
          std::string ver_a = abi["version"].as<std::string>();
          std::string ver_b = b["version"].as<std::string>();
          return std::stod(ver_a.substr(ver_a.size()-3))*10 < std::stod(ver_b.substr(ver_b.size()-3))*10 ?
             ver_b : ver_a;
       }
 
-      static bool struct_is_same(ojson a, ojson b) {
-         bool same_fields = a["fields"].size() == b["fields"].size();
-         for (auto a_field : a["fields"].array_range()) {
-            bool found_field = false;
-            for (auto b_field : b["fields"].array_range()) {
-               if (a_field["name"] == b_field["name"] &&
-                   a_field["type"] == b_field["type"])
-                  found_field = true;
-            }
-            if (!found_field)
-               return false;
-         }
-         return a["name"] == b["name"] &&
-                a["base"] == b["base"] && same_fields;
+      // member `key` of `obj`, null if it is missing
+      static const ojson& get(const ojson& obj, const char* key) {
+         auto it = obj.find(key);
+         return it == obj.object_range().end() ? ojson::null() : it->value();
       }
 
-      static bool type_is_same(ojson a, ojson b) {
-         return a["new_type_name"] == b["new_type_name"] &&
-                a["type"] == b["type"];
+      // array `type` of `obj`, empty if it is missing
+      static const ojson& section(const ojson& obj, const char* type) {
+         static const ojson empty = ojson::array();
+         const ojson& sec = get(obj, type);
+         return sec.is_array() ? sec : empty;
       }
 
-      static bool action_is_same(ojson a, ojson b) {
-         return a["name"] == b["name"] &&
-                a["type"] == b["type"] &&
-                a["ricardian_contract"] == b["ricardian_contract"];
+      static std::string key_of(const ojson& obj, const char* id) {
+         const ojson& key = get(obj, id);
+         return key.is_string() ? key.as<std::string>() : key.to_string();
       }
 
-      template <typename T>
-      static bool action_is_almost_same(ojson a, ojson b, T& rc) {
-         if (a["ricardian_contract"].empty())
-            rc = b["ricardian_contract"];
-         return a["name"] == b["name"] &&
-                a["type"] == b["type"];
+      // structs are the same if they have the same base and the same set of fields, in any order
+      static bool struct_is_same(const ojson& a, const ojson& b) {
+         if (get(a, "name") != get(b, "name") || get(a, "base") != get(b, "base"))
+            return false;
+         const ojson& a_fields = section(a, "fields");
+         const ojson& b_fields = section(b, "fields");
+         if (a_fields.size() != b_fields.size())
+            return false;
+         std::unordered_set<std::string> fields;
+         for (const auto& b_field : b_fields.array_range())
+            fields.insert(key_of(b_field, "name") + '\0' + key_of(b_field, "type"));
+         for (const auto& a_field : a_fields.array_range()) {
+            if (!fields.count(key_of(a_field, "name") + '\0' + key_of(a_field, "type")))
+               return false;
+         }
+         return true;
       }
 
-      static bool call_is_same(ojson a, ojson b) {
-         return a["name"] == b["name"] &&
-                a["type"] == b["type"];
+      static bool type_is_same(const ojson& a, const ojson& b) {
+         return get(a, "new_type_name") == get(b, "new_type_name") &&
+                get(a, "type") == get(b, "type");
       }
 
-      static bool variant_is_same(ojson a, ojson b) {
-         for (auto tya : a["types"].array_range()) {
-            bool found_ty = false;
-            for (auto tyb : b["types"].array_range()) {
-               if (tyb == tya)
-                  found_ty = true;
-            }
-            if (!found_ty)
+      static bool action_is_same(const ojson& a, const ojson& b) {
+         return get(a, "name") == get(b, "name") &&
+                get(a, "type") == get(b, "type") &&
+                get(a, "ricardian_contract") == get(b, "ricardian_contract");
+      }
+
+      static bool call_is_same(const ojson& a, const ojson& b) {
+         return get(a, "name") == get(b, "name") &&
+                get(a, "type") == get(b, "type");
+      }
+
+      // the types of variant `a` have to be a subset of the types of `b`
+      static bool variant_is_same(const ojson& a, const ojson& b) {
+         if (get(a, "name") != get(b, "name"))
+            return false;
+         std::unordered_set<std::string> types;
+         for (const auto& tyb : section(b, "types").array_range())
+            types.insert(tyb.to_string());
+         for (const auto& tya : section(a, "types").array_range()) {
+            if (!types.count(tya.to_string()))
                return false;
          }
-         return a["name"] == b["name"];
+         return true;
       }
 
-      static bool table_is_same(ojson a, ojson b) {
-         return a["name"] == b["name"] &&
-                a["type"] == b["type"] &&
-                a["index_type"] == b["index_type"] &&
-                a["key_names"] == b["key_names"] &&
-                a["key_types"] == b["key_types"];
+      static bool table_is_same(const ojson& a, const ojson& b) {
+         return get(a, "name") == get(b, "name") &&
+                get(a, "type") == get(b, "type") &&
+                get(a, "index_type") == get(b, "index_type") &&
+                get(a, "key_names") == get(b, "key_names") &&
+                get(a, "key_types") == get(b, "key_types");
       }
 
-      static bool clause_is_same(ojson a, ojson b) {
-         return a["id"] == b["id"] &&
-                a["body"] == b["body"];
+      static bool clause_is_same(const ojson& a, const ojson& b) {
+         return get(a, "id") == get(b, "id") &&
+                get(a, "body") == get(b, "body");
       }
 
-      static bool action_result_is_same(ojson a, ojson b) {
-         return a["name"] == b["name"] &&
-                a["result_type"] == b["result_type"];
+      static bool action_result_is_same(const ojson& a, const ojson& b) {
+         return get(a, "name") == get(b, "name") &&
+                get(a, "result_type") == get(b, "result_type");
       }
 
+      // Append the elements of section `type` of `a`, then those of `b` whose `id` is not defined in `a`.
+      // The elements of `a` are indexed by `id` once, so every element of `b` is matched in constant time;
+      // identical definitions are recognized by a content comparison before falling back to `is_same_func`.
       template <typename F>
-      void add_object_to_array(ojson& ret, ojson a, ojson b, std::string type, std::string id, F&& is_same_func) {
-         for (auto obj_a : a[type].array_range()) {
+      static void add_object_to_array(ojson& ret, const ojson& a, const ojson& b, const char* type, const char* id, F&& is_same_func) {
+         const ojson& a_objs = section(a, type);
+         const ojson& b_objs = section(b, type);
+         ret.reserve(a_objs.size() + b_objs.size());
+
+         std::unordered_multimap<std::string, const ojson*> a_index;
+         for (const auto& obj_a : a_objs.array_range()) {
             ret.push_back(obj_a);
+            a_index.emplace(key_of(obj_a, id), &obj_a);
          }
-         for (auto obj_b : b[type].array_range()) {
+         for (const auto& obj_b : b_objs.array_range()) {
             bool should_skip = false;
-            for (auto obj_a : a[type].array_range()) {
-               if (obj_a[id] == obj_b[id]) {
-                  if (!is_same_func(obj_a, obj_b)) {
-                     throw std::runtime_error(std::string("Error, ABI structs malformed : ")+obj_a[id].as<std::string>()+" already defined");
-                  }
-                  else
-                     should_skip = true;
+            auto range = a_index.equal_range(key_of(obj_b, id));
+            for (auto it = range.first; it != range.second; ++it) {
+               const ojson& obj_a = *it->second;
+               if (obj_a != obj_b && !is_same_func(obj_a, obj_b)) {
+                  throw std::runtime_error(std::string("Error, ABI structs malformed : ")+key_of(obj_a, id)+" already defined");
                }
+               should_skip = true;
             }
             if (!should_skip)
                ret.push_back(obj_b);
          }
       }
 
-      void add_object_to_object(ojson& ret, ojson a, ojson b, std::string type, std::string id) {
-         for (auto obj_a : a[type].object_range()) {
-            ret.insert_or_assign(obj_a.key(), obj_a.value());
-         }
-         for (auto obj_b : b[type].object_range()) {
-            bool should_skip = false;
-            for (auto obj_a : a[type].object_range()) {
-               if (obj_a.key() == obj_b.key()) {
-                  if (obj_a.value() != obj_b.value()) {
-                     throw std::runtime_error(std::string("Error, ABI structs malformed : ")+std::string(obj_a.key().data(), obj_a.key().size())+" already defined");
-                  }
-                  else {
-                     should_skip = true;
-                  }
-               }
-            }
-            if (!should_skip) {
-               ret.insert_or_assign(obj_b.key(), obj_b.value());
-            }
-         }
+      ojson merge_section(const ojson& b, const char* type, const char* id, bool (*is_same_func)(const ojson&, const ojson&))const {
+         ojson objs = ojson::array();
+         add_object_to_array(objs, abi, b, type, id, is_same_func);
+         return objs;
       }
 
-      ojson merge_structs(ojson b) {
-         ojson structs = ojson::array();
-         add_object_to_array(structs, abi, b, "structs", "name", struct_is_same);
-         return structs;
+      ojson merge_structs(const ojson& b)const {
+         return merge_section(b, "structs", "name", struct_is_same);
       }
 
-      ojson merge_types(ojson b) {
-         ojson types = ojson::array();
-         add_object_to_array(types, abi, b, "types", "new_type_name", type_is_same);
-         return types;
+      ojson merge_types(const ojson& b)const {
+         return merge_section(b, "types", "new_type_name", type_is_same);
       }
 
-      ojson merge_variants(ojson b) {
-         ojson vars = ojson::array();
-         add_object_to_array(vars, abi, b, "variants", "name", variant_is_same);
-         return vars;
+      ojson merge_variants(const ojson& b)const {
+         return merge_section(b, "variants", "name", variant_is_same);
       }
 
-      ojson merge_actions(ojson b) {
-         ojson acts = ojson::array();
-         add_object_to_array(acts, abi, b, "actions", "name", action_is_same);
-         return acts;
+      ojson merge_actions(const ojson& b)const {
+         return merge_section(b, "actions", "name", action_is_same);
       }
 
-      ojson merge_calls(ojson b) {
-         ojson calls = ojson::array();
-         add_object_to_array(calls, abi, b, "calls", "name", call_is_same);
-         return calls;
+      ojson merge_calls(const ojson& b)const {
+         return merge_section(b, "calls", "name", call_is_same);
       }
 
-      ojson merge_tables(ojson b) {
-         ojson tabs = ojson::array();
-         add_object_to_array(tabs, abi, b, "tables", "name", table_is_same);
-         return tabs;
+      ojson merge_tables(const ojson& b)const {
+         return merge_section(b, "tables", "name", table_is_same);
       }
 
-      ojson merge_clauses(ojson b) {
-         ojson cls = ojson::array();
-         add_object_to_array(cls, abi, b, "ricardian_clauses", "id", clause_is_same);
-         return cls;
+      ojson merge_clauses(const ojson& b)const {
+         return merge_section(b, "ricardian_clauses", "id", clause_is_same);
       }
 
-      ojson merge_action_results(ojson b) {
-         ojson res = ojson::array();
-         add_object_to_array(res, abi, b, "action_results", "name", action_result_is_same);
-         return res;
+      ojson merge_action_results(const ojson& b)const {
+         return merge_section(b, "action_results", "name", action_result_is_same);
       }
 
       ojson abi;
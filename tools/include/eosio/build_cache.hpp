@@ -0,0 +1,86 @@
+#pragma once
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <string>
+
+namespace eosio { namespace cdt { namespace build_cache {
+
+   // Content addressed key of a cache entry, hashed over everything the cached outputs depend on
+   class key_builder {
+      public:
+         explicit key_builder(llvm::StringRef version) { add(version); }
+
+         key_builder& add(llvm::StringRef data) {
+            hash.update(data);
+            hash.update(llvm::StringRef("\0", 1));
+            return *this;
+         }
+
+         // hash the content of a file, a missing file hashes differently from an empty one
+         key_builder& add_file(llvm::StringRef path) {
+            auto buf = llvm::MemoryBuffer::getFile(path);
+            if (!buf)
+               return add("<missing>");
+            add(buf.get()->getBuffer());
+            return *this;
+         }
+
+         std::string digest() {
+            llvm::MD5::MD5Result result;
+            hash.final(result);
+            return result.digest().str().str();
+         }
+
+      private:
+         llvm::MD5 hash;
+   };
+
+   inline std::string entry_path(const std::string& dir, const std::string& key, llvm::StringRef suffix) {
+      return dir + llvm::sys::path::get_separator().str() + key + suffix.str();
+   }
+
+   // Copy the cached file for `key` to `dest`, returns false on a cache miss
+   inline bool fetch(const std::string& dir, const std::string& key, llvm::StringRef suffix, const std::string& dest) {
+      const std::string entry = entry_path(dir, key, suffix);
+      if (!llvm::sys::fs::exists(entry))
+         return false;
+      return !llvm::sys::fs::copy_file(entry, dest);
+   }
+
+   inline bool contains(const std::string& dir, const std::string& key, llvm::StringRef suffix) {
+      return llvm::sys::fs::exists(entry_path(dir, key, suffix));
+   }
+
+   // Store `src` as the cached file for `key`. Entries are copied to a unique file first and renamed,
+   // so concurrent builds never read a partial entry. Failing to store is not an error, only a warning.
+   inline void store(const std::string& dir, const std::string& key, llvm::StringRef suffix, const std::string& src) {
+      if (llvm::sys::fs::create_directories(dir)) {
+         llvm::errs() << "warning: failed to create the build cache directory " << dir << "\n";
+         return;
+      }
+      const std::string entry = entry_path(dir, key, suffix);
+      llvm::SmallString<128> tmp;
+      if (llvm::sys::fs::createUniqueFile(entry + "-%%%%%%", tmp) ||
+          llvm::sys::fs::copy_file(src, tmp) ||
+          llvm::sys::fs::rename(tmp, entry)) {
+         llvm::sys::fs::remove(tmp);
+         llvm::errs() << "warning: failed to store " << src << " in the build cache\n";
+      }
+   }
+
+   // The default build cache directory, in the user's cache directory
+   inline std::string default_dir() {
+      llvm::SmallString<128> dir;
+      if (!llvm::sys::path::cache_directory(dir))
+         llvm::sys::path::system_temp_directory(true, dir);
+      llvm::sys::path::append(dir, "cdt", "cache");
+      return dir.str().str();
+   }
+}}} // ns eosio::cdt::build_cache
@@ -23,6 +23,7 @@
 #include <eosio/abi.hpp>
 #include <eosio/ppcallbacks.hpp>
 
+#include <algorithm>
 #include <exception>
 #include <iostream>
 #include <fstream>
@@ -33,7 +34,6 @@
 #include <chrono>
 #include <ctime>
 #include <utility>
-#include <regex>
 
 using namespace clang;
 using namespace clang::driver;
@@ -62,6 +62,7 @@ namespace eosio { namespace cdt {
          llvm::ArrayRef<std::string>           sources;
          size_t                                source_index = 0;
          std::map<std::string, std::string>    tmp_files;
+         std::string                           generated_file; // path of the generated source, a temporary file if empty
          bool                                  warn_action_read_only;
 
          using generation_utils::generation_utils;
@@ -79,6 +80,10 @@ namespace eosio { namespace cdt {
             abi = s;
          }
 
+         void set_generated_file(std::string fn) {
+            generated_file = fn;
+         }
+
          void set_warn_action_read_only(bool w) {
             warn_action_read_only = w;
          }
@@ -93,10 +98,41 @@ namespace eosio { namespace cdt {
          CompilerInstance* ci;
          bool apply_was_found = false;
 
+         // `eosio::datastream` and `eosio::contract` of this translation unit, looked up on first use
+         bool                     eosio_decls_resolved = false;
+         const ClassTemplateDecl* datastream_decl      = nullptr;
+         const CXXRecordDecl*     contract_decl        = nullptr;
+
+         void resolve_eosio_decls() {
+            if (eosio_decls_resolved)
+               return;
+            eosio_decls_resolved = true;
+            auto& ctx = *cg.ast_context;
+            for (auto ns_decl : ctx.getTranslationUnitDecl()->lookup(&ctx.Idents.get("eosio"))) {
+               auto ns = dyn_cast<NamespaceDecl>(ns_decl);
+               if (!ns)
+                  continue;
+               for (auto d : ns->lookup(&ctx.Idents.get("datastream")))
+                  if (auto ctd = dyn_cast<ClassTemplateDecl>(d))
+                     datastream_decl = ctd->getCanonicalDecl();
+               for (auto d : ns->lookup(&ctx.Idents.get("contract")))
+                  if (auto rd = dyn_cast<CXXRecordDecl>(d))
+                     contract_decl = rd->getCanonicalDecl();
+            }
+         }
+
       public:
          std::vector<CXXMethodDecl*> action_decls;
          std::vector<CXXMethodDecl*> notify_decls;
 
+         // name of the sync call executing batches, must match `eosio::call_batch::batch_function_name`
+         static constexpr const char* batch_call_name = "eosio_call_batch";
+         // prefix of the entries of the sync calls executed in batches, cdt-ld generates the
+         // batch dispatcher from the entries defined by the linked objects, must match cdt-ld
+         static constexpr const char* batch_entry_prefix = "__eosio_batch_call_";
+         // hash_id of every sync call of the contract and the method it calls
+         std::map<uint64_t, std::string> batch_calls;
+
          using call_map_t = std::map<FunctionDecl*, std::vector<CallExpr*>>;
          using indirect_func_map_t = std::map<NamedDecl*, FunctionDecl*>;
 
@@ -121,11 +157,23 @@ namespace eosio { namespace cdt {
 
          auto& get_ss() { return ss; }
 
+         // `eosio::datastream<...>&`, or a reference to a template parameter named `DataStream`
          bool is_datastream(const QualType& qt) {
-            auto str_name = qt.getAsString();
-            auto ds_re    = std::regex("(((class eosio::)?datastream<[a-zA-Z]+[a-zA-Z0-9]*.*>)|(DataStream)) &");
-            if (std::regex_match(str_name, ds_re))
-               return true;
+            if (!qt->isLValueReferenceType())
+               return false;
+            QualType pointee = qt.getNonReferenceType();
+            if (pointee.hasQualifiers())
+               return false;
+            if (auto tpt = pointee->getAs<TemplateTypeParmType>())
+               return tpt->getIdentifier() && tpt->getIdentifier()->getName() == "DataStream";
+            resolve_eosio_decls();
+            if (!datastream_decl)
+               return false;
+            if (auto tst = pointee->getAs<TemplateSpecializationType>())
+               if (auto td = tst->getTemplateName().getAsTemplateDecl())
+                  return td->getCanonicalDecl() == datastream_decl;
+            if (auto spec = dyn_cast_or_null<ClassTemplateSpecializationDecl>(pointee->getAsCXXRecordDecl()))
+               return spec->getSpecializedTemplate()->getCanonicalDecl() == datastream_decl;
             return false;
          }
          bool is_type_of(const QualType& qt, const std::string& t, const std::string& ns="") {
@@ -148,13 +196,16 @@ namespace eosio { namespace cdt {
 
          // Return `true` if the method `decl`'s base class if `eosio::contract`
          bool base_is_eosio_contract_class(const clang::CXXMethodDecl* decl) {
+            resolve_eosio_decls();
+            if (!contract_decl)
+               return false;
             auto cxx_decl = decl->getParent();
             // on this point it could be just an attribute so let's check base classes
             for (const auto& base : cxx_decl->bases()) {
                if (const clang::Type *base_type = base.getType().getTypePtrOrNull()) {
                   if (const auto* cur_cxx_decl = base_type->getAsCXXRecordDecl()) {
-                     if (cur_cxx_decl->getQualifiedNameAsString() == "eosio::contract") {
-                        return true;;
+                     if (cur_cxx_decl->getCanonicalDecl() == contract_decl) {
+                        return true;
                      }
                   }
                }
@@ -162,6 +213,39 @@ namespace eosio { namespace cdt {
             return false;
          }
 
+         // Emit the argument list of the call to the action or call handler.
+         // The deserialized `argN` locals are not used afterwards, so they are moved
+         // into the handler unless the parameter is an lvalue reference.
+         void emit_unpack_arguments(const clang::CXXMethodDecl* decl) {
+            int i=0;
+            for (auto param : decl->parameters()) {
+               clang::LangOptions lang_opts;
+               lang_opts.CPlusPlus = true;
+               lang_opts.Bool = true;
+               clang::PrintingPolicy policy(lang_opts);
+               auto qt = param->getOriginalType().getNonReferenceType();
+               qt.removeLocalConst();
+               qt.removeLocalVolatile();
+               qt.removeLocalRestrict();
+               std::string tn = clang::TypeName::getFullyQualifiedName(qt, *(cg.ast_context), policy);
+               ss << tn << " arg" << i << "; ds >> arg" << i << ";\n";
+               i++;
+            }
+         }
+
+         void emit_call_arguments(const clang::CXXMethodDecl* decl) {
+            int i=0;
+            for (auto param : decl->parameters()) {
+               if (i > 0)
+                  ss << ", ";
+               if (param->getType()->isLValueReferenceType())
+                  ss << "arg" << i;
+               else
+                  ss << "std::move(arg" << i << ")";
+               i++;
+            }
+         }
+
          template <typename F>
          void create_dispatch(const std::string& attr, const std::string& func_name, F&& get_str, CXXMethodDecl* decl) {
             constexpr static uint32_t max_stack_size = 512;
@@ -176,8 +260,8 @@ namespace eosio { namespace cdt {
                ss << "uint32_t action_data_size();\n";
                ss << "__attribute__((eosio_wasm_import))\n";
                ss << "uint32_t read_action_data(void*, uint32_t);\n";
-               const auto& return_ty = decl->getReturnType().getAsString();	
-               if (return_ty != "void") {	
+               const bool returns_value = !decl->getReturnType()->isVoidType();
+               if (returns_value) {
                   ss << "__attribute__((eosio_wasm_import))\n";	
                   ss << "void set_action_return_value(void*, size_t);\n";	
                }
@@ -193,20 +277,7 @@ namespace eosio { namespace cdt {
                ss << "::read_action_data(buff, as);\n";
                ss << "}\n";
                ss << "eosio::datastream<const char*> ds{(char*)buff, as};\n";
-               int i=0;
-               for (auto param : decl->parameters()) {
-                  clang::LangOptions lang_opts;
-                  lang_opts.CPlusPlus = true;
-                  lang_opts.Bool = true;
-                  clang::PrintingPolicy policy(lang_opts);
-                  auto qt = param->getOriginalType().getNonReferenceType();
-                  qt.removeLocalConst();
-                  qt.removeLocalVolatile();
-                  qt.removeLocalRestrict();
-                  std::string tn = clang::TypeName::getFullyQualifiedName(qt, *(cg.ast_context), policy);
-                  ss << tn << " arg" << i << "; ds >> arg" << i << ";\n";
-                  i++;
-               }
+               emit_unpack_arguments(decl);
 
                // Create contract object
                ss << decl->getParent()->getQualifiedNameAsString()
@@ -223,20 +294,16 @@ namespace eosio { namespace cdt {
 
                const auto& call_action = [&]() {
                   ss << "obj." << decl->getNameAsString() << "(";
-                  for (int i=0; i < decl->parameters().size(); i++) {
-                     ss << "arg" << i;
-                     if (i < decl->parameters().size()-1)
-                        ss << ", ";
-                  }
+                  emit_call_arguments(decl);
                   ss << ");\n";
                };
-               if (return_ty != "void") {
+               if (returns_value) {
                   ss << "const auto& result = ";
                }
                call_action();
-               if (return_ty != "void") {
-                  ss << "const auto& packed_result = eosio::pack(result);\n";
-                  ss << "set_action_return_value((void*)packed_result.data(), packed_result.size());\n";
+               if (returns_value) {
+                  // packed on the stack or into a reused buffer, read-only queries return on every call
+                  ss << "eosio::with_packed(result, [](const char* data, size_t size) { ::set_action_return_value((void*)data, size); });\n";
                }
                ss << "}}\n";
 
@@ -265,8 +332,8 @@ namespace eosio { namespace cdt {
                ss << "\n\n#include <eosio/datastream.hpp>\n";
                ss << "#include <eosio/call.hpp>\n";
                ss << "extern \"C\" {\n";
-               const auto& return_ty = decl->getReturnType().getAsString();
-               if (return_ty != "void") {
+               const bool returns_value = !decl->getReturnType()->isVoidType();
+               if (returns_value) {
                   ss << "__attribute__((eosio_wasm_import))\n";
                   ss << "void set_call_return_value(void*, size_t);\n";
                }
@@ -277,20 +344,7 @@ namespace eosio { namespace cdt {
                ss << "\"))) void " << func_name << nm << "(unsigned long long sender, unsigned long long receiver, size_t data_size, void* data) {\n";
                ss << "eosio::datastream<const char*> ds{(char*)data, data_size};\n";
                ss << "eosio::call_data_header header; ds >> header;\n";  // skip header
-               int i=0;
-               for (auto param : decl->parameters()) {
-                  clang::LangOptions lang_opts;
-                  lang_opts.CPlusPlus = true;
-                  lang_opts.Bool = true;
-                  clang::PrintingPolicy policy(lang_opts);
-                  auto qt = param->getOriginalType().getNonReferenceType();
-                  qt.removeLocalConst();
-                  qt.removeLocalVolatile();
-                  qt.removeLocalRestrict();
-                  std::string tn = clang::TypeName::getFullyQualifiedName(qt, *(cg.ast_context), policy);
-                  ss << tn << " arg" << i << "; ds >> arg" << i << ";\n";
-                  i++;
-               }
+               emit_unpack_arguments(decl);
 
                // Create contract object
                ss << decl->getParent()->getQualifiedNameAsString()
@@ -307,25 +361,59 @@ namespace eosio { namespace cdt {
 
                const auto& call_function = [&]() {
                   ss << "obj." << decl->getNameAsString() << "(";
-                  for (int i=0; i < decl->parameters().size(); i++) {
-                     ss << "arg" << i;
-                     if (i < decl->parameters().size()-1)
-                        ss << ", ";
-                  }
+                  emit_call_arguments(decl);
                   ss << ");\n";
                };
-               if (return_ty != "void") {
+               if (returns_value) {
+                  ss << "const auto& result = ";
+               }
+               call_function();
+               if (returns_value) {
+                  ss << "eosio::with_packed(result, [](const char* data, size_t size) { ::set_call_return_value((void*)data, size); });\n";
+               }
+               ss << "}}\n";
+
+               // Entry used by the batch dispatcher: reads the arguments from the batch payload
+               // and packs the result instead of setting the call return value. It is named after
+               // the hash_id of the call, for cdt-ld to find the entries of every object.
+               const uint64_t id = to_hash_id(call_name);
+               const auto [entry, inserted] = batch_calls.emplace(id, nm);
+               if (!inserted && entry->second != nm) {
+                  CDT_ERROR("codegen_error", decl->getLocation(), "sync call " + call_name + " has the hash_id of another sync call");
+                  return;
+               }
+               ss << "extern \"C\" {\n";
+               ss << "__attribute__((weak)) void " << batch_entry_prefix << id << "(unsigned long long receiver, void* ds_ptr, void* result_ptr) {\n";
+               ss << "auto& ds = *static_cast<eosio::datastream<const char*>*>(ds_ptr);\n";
+               emit_unpack_arguments(decl);
+               ss << decl->getParent()->getQualifiedNameAsString()
+                  << " obj {eosio::name{receiver},eosio::name{receiver},ds};\n";
+               if (base_is_eosio_contract_class(decl)) {
+                  ss << "obj.set_exec_type(eosio::contract::exec_type_t::call);\n";
+               }
+               if (returns_value) {
                   ss << "const auto& result = ";
                }
                call_function();
-               if (return_ty != "void") {
-                  ss << "const auto& packed_result = eosio::pack(result);\n";
-                  ss << "::set_call_return_value((void*)packed_result.data(), packed_result.size());\n";
+               if (returns_value) {
+                  ss << "*static_cast<std::vector<char>*>(result_ptr) = eosio::pack(result);\n";
                }
                ss << "}}\n";
             }
          }
 
+         // Generate the function executing a batch of calls built by `eosio::call_batch`. The sync call
+         // receiving the batch is generated by cdt-ld, which knows the entries of every linked object,
+         // and calls this function with the sorted hash_ids of the calls and their entries.
+         void create_execute_call_batch() {
+            ss << "\n\n#include <eosio/call.hpp>\n";
+            ss << "extern \"C\" {\n";
+            ss << "__attribute__((weak)) void __eosio_execute_call_batch(unsigned long long receiver, const void* data, size_t data_size, ";
+            ss << "const uint64_t* ids, const eosio::detail::batch_call_entry* entries, size_t count) {\n";
+            ss << "eosio::detail::execute_call_batch(receiver, data, data_size, ids, entries, count);\n";
+            ss << "}}\n";
+         }
+
          // Generate get_sync_call_data_version which returns the version of call data.
          // In version 0, call data is packed as header + arguments, where
          // header is `struct header { uint32_t version; uint64_t func_name }`
@@ -419,6 +507,9 @@ namespace eosio { namespace cdt {
                validate_hash_id(name, [&](auto s) {
                   CDT_ERROR("codegen_error", decl->getLocation(), std::string("call name (")+s+") is not a valid C++ identifier");
                });
+               if (to_hash_id(name) == to_hash_id(batch_call_name)) {
+                  CDT_ERROR("codegen_error", decl->getLocation(), std::string("call name (")+name+") is reserved for batched sync calls");
+               }
 
                // Make sure there are no conflicts of IDs
                auto id = to_hash_id(name);
@@ -623,7 +714,10 @@ namespace eosio { namespace cdt {
 
       public:
          explicit eosio_codegen_consumer(CompilerInstance *CI, std::string file)
-            : visitor(new eosio_codegen_visitor(CI)), main_file(file), ci(CI) { }
+            : visitor(new eosio_codegen_visitor(CI)), main_file(file), ci(CI) {
+            // cached types are only valid in the ASTContext of the previous translation unit
+            generation_utils::clear_type_cache();
+         }
 
 
          virtual void HandleTranslationUnit(ASTContext &Context) {
@@ -644,13 +738,19 @@ namespace eosio { namespace cdt {
                for (auto nd : visitor->notify_decls)
                   visitor->create_notify_dispatch(nd);
 
+               if (!visitor->batch_calls.empty())
+                  visitor->create_execute_call_batch();
+
                if (cg.actions.size() < 1 && cg.notify_handlers.size() < 1 && cg.calls.size() < 1) {
                   return;
                }
 
                llvm::SmallString<128> fn;
                try {
-                  llvm::sys::fs::createTemporaryFile("antelope", ".cpp", fn);
+                  if (cg.generated_file.empty())
+                     llvm::sys::fs::createTemporaryFile("antelope", ".cpp", fn);
+                  else
+                     fn = cg.generated_file;
 
                   std::ofstream out(fn.c_str());
                   {
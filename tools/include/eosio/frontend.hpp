@@ -0,0 +1,49 @@
+#pragma once
+
+#include <eosio/abigen.hpp>
+#include <eosio/codegen.hpp>
+#include <eosio/time_report.hpp>
+
+namespace eosio { namespace cdt {
+   // Generates the ABI and the dispatch stubs from a single parse of the translation unit.
+   // The abigen pass runs first on the AST so the ABI can be embedded by the codegen pass.
+   class eosio_frontend_consumer : public ASTConsumer {
+      private:
+         eosio_abigen_consumer  abigen_consumer;
+         eosio_codegen_consumer codegen_consumer;
+         std::string            main_file;
+
+      public:
+         // set when the abigen pass reported errors and codegen was skipped
+         static inline bool abigen_failed = false;
+
+         explicit eosio_frontend_consumer(CompilerInstance *CI, std::string file)
+            : abigen_consumer(CI, file), codegen_consumer(CI, file), main_file(file) { }
+
+         virtual void HandleTranslationUnit(ASTContext &Context) {
+            {
+               time_report::scope phase("abigen", "frontend", main_file);
+               abigen_consumer.HandleTranslationUnit(Context);
+            }
+            abigen_failed = Context.getDiagnostics().hasErrorOccurred();
+            if (abigen_failed)
+               return;
+
+            time_report::scope phase("codegen", "frontend", main_file);
+            if (!abigen::get().is_empty()) {
+               std::string abi_s;
+               abigen::get().to_json().dump(abi_s);
+               codegen::get().set_abi(abi_s);
+            }
+            codegen_consumer.HandleTranslationUnit(Context);
+         }
+   };
+
+   class eosio_frontend_action : public ASTFrontendAction {
+      public:
+         virtual std::unique_ptr<ASTConsumer> CreateASTConsumer(CompilerInstance &CI, StringRef file) {
+            CI.getPreprocessor().addPPCallbacks(std::make_unique<eosio_ppcallbacks>(CI.getSourceManager(), file.str()));
+            return std::make_unique<eosio_frontend_consumer>(&CI, file);
+         }
+   };
+}} // ns eosio::cdt
@@ -13,6 +13,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <set>
 #include <unordered_map>
 #include <regex>
 #include <utility>
@@ -118,6 +119,34 @@ struct generation_utils {
       return ee;
    }
 
+   // Memoized results of translate_type, is_builtin_type and get_base_type_name. Types are keyed by the
+   // QualType as written, not the canonical one, as aliases translate to their own names. The keys are
+   // only meaningful within one ASTContext, so the cache is cleared for every translation unit.
+   struct type_cache {
+      std::unordered_map<void*, std::string> translated;
+      std::unordered_map<void*, bool>        builtin;
+      std::unordered_map<void*, std::string> base_names;
+   };
+
+   static type_cache& get_type_cache() {
+      static type_cache tc;
+      return tc;
+   }
+
+   static void clear_type_cache() {
+      get_type_cache() = {};
+   }
+
+   template <typename T, typename F>
+   static T memoize( std::unordered_map<void*, T>& cache, const clang::QualType& type, F&& compute ) {
+      auto it = cache.find(type.getAsOpaquePtr());
+      if (it != cache.end())
+         return it->second;
+      T ret = compute();
+      cache.emplace(type.getAsOpaquePtr(), ret);
+      return ret;
+   }
+
    static inline bool is_ignorable( const clang::QualType& type ) {
       auto check = [&](const clang::Type* pt) {
         if (auto tst = llvm::dyn_cast<clang::TemplateSpecializationType>(pt))
@@ -223,9 +252,13 @@ struct generation_utils {
       return contract_name+".clauses.md";
    }
 
+   // resource files read while generating the ABI, listed in the dependency files
+   static inline std::set<std::string> resources_read;
+
    inline std::string read_file( const std::string& fname ) {
       for ( auto res : resource_dirs ) {
          if ( llvm::sys::fs::exists( res + "/" + fname ) ) {
+            resources_read.insert(res + "/" + fname);
             int fd;
             llvm::sys::fs::file_status stat;
             llvm::sys::fs::openFileForRead(res+"/"+fname, fd);
@@ -394,9 +427,9 @@ struct generation_utils {
    }
 
    std::string get_base_type_name( const clang::QualType& type ) {
-      clang::QualType newType = type;
-      std::string type_str = newType.getNonReferenceType().getAsString();
-      return get_base_type_name(type_str);
+      return memoize(get_type_cache().base_names, type, [&]() {
+         return get_base_type_name(type.getNonReferenceType().getAsString());
+      });
    }
 
    std::string get_base_type_name( const std::string& type_str ) {
@@ -472,6 +505,8 @@ struct generation_utils {
          {"signed_int",   "varint32"},
 
          {"basic_string<char>", "string"},
+         {"basic_string_view<char>", "string"},
+         {"string_view", "string"},
 
          {"block_timestamp", "block_timestamp_type"},
          {"capi_name",    "name"},
@@ -665,6 +700,10 @@ struct generation_utils {
    }
 
    inline std::string translate_type( const clang::QualType& type ) {
+      return memoize(get_type_cache().translated, type, [&]() { return translate_type_uncached(type); });
+   }
+
+   std::string translate_type_uncached( const clang::QualType& type ) {
       if(is_explicit_nested(type)){
          return translate_explicit_nested_type(type.getNonReferenceType());
       }
@@ -682,6 +721,15 @@ struct generation_utils {
             return t+"[]";
          }
       }
+      // std::span<const char> parameters are views into the action data
+      else if ( is_template_specialization( type, {"span"} ) ) {
+         auto t = get_template_argument_as_string( type );
+         if ( t=="int8" || t=="uint8" ) {
+            return "bytes";
+         } else {
+            return t+"[]";
+         }
+      }
       //The following else if (is_tuple(type)) block is removed, because it causes eosio-cpp compilation
       //failure on any action that has std::tuple<Ts...> parameter, also the type eosio::non_unique this block
       //was supposed to handle is obsolete now.
@@ -787,8 +835,7 @@ struct generation_utils {
    }
 
    inline bool is_builtin_type( const clang::QualType& t ) {
-      std::string nt = translate_type(t);
-      return is_builtin_type(nt);
+      return memoize(get_type_cache().builtin, t, [&]() { return is_builtin_type(translate_type(t)); });
    }
 
    inline bool is_cxx_record( const clang::QualType& t ) {
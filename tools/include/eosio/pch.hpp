@@ -0,0 +1,185 @@
+#pragma once
+
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <eosio/utils.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace eosio { namespace cdt { namespace pch {
+
+   // the header precompiled for the contract translation units including it first
+   static constexpr const char* header_name = "eosio/eosio.hpp";
+   static constexpr const char* header_source = "#include <eosio/eosio.hpp>\n";
+
+   // -include-pch includes the precompiled header before the first line of the source, which only
+   // compiles the same as the source when its first directive is the include of the header.
+   // Comments and blank lines may precede it.
+   inline bool includes_header_first(const std::string& source) {
+      auto buf = llvm::MemoryBuffer::getFile(source);
+      if (!buf)
+         return false;
+      llvm::StringRef text = buf.get()->getBuffer();
+      for (;;) {
+         text = text.ltrim();
+         if (text.startswith("//")) {
+            text = text.drop_front(std::min(text.find('\n'), text.size()));
+         } else if (text.startswith("/*")) {
+            size_t end = text.find("*/", 2);
+            if (end == llvm::StringRef::npos)
+               return false;
+            text = text.drop_front(end + 2);
+         } else {
+            break;
+         }
+      }
+      if (!text.consume_front("#"))
+         return false;
+      text = text.ltrim(" \t");
+      if (!text.consume_front("include"))
+         return false;
+      text = text.ltrim(" \t");
+      return text.startswith(std::string("<") + header_name + ">") ||
+             text.startswith(std::string("\"") + header_name + "\"");
+   }
+
+   // Compiler options the precompiled header has to be built with: everything but the options
+   // selecting the input language, the kind of output and the dependency files.
+   inline std::vector<std::string> header_options(const std::vector<std::string>& copts) {
+      static const std::set<std::string> output_opts = {
+         "-c", "-S", "-E", "-C", "-dD", "-dI", "-dM", "-emit-llvm", "-emit-ast", "-MD", "-MMD", "-v"
+      };
+      static const std::set<std::string> output_opts_with_arg = { "-MF", "-MT" };
+
+      std::vector<std::string> opts;
+      for (size_t i=0; i < copts.size(); i++) {
+         const auto& opt = copts[i];
+         if (output_opts.count(opt))
+            continue;
+         if (output_opts_with_arg.count(opt)) {
+            i++;
+            continue;
+         }
+         if (opt.rfind("-x", 0) == 0 || opt.rfind("-include=", 0) == 0)
+            continue;
+         opts.push_back(opt);
+      }
+      return opts;
+   }
+
+   // The precompiled header is stale if any of the files listed in its dependency file
+   // is missing or was modified after it was built.
+   inline bool is_up_to_date(const std::string& pch_file, const std::string& deps_file) {
+      llvm::sys::fs::file_status pch_status;
+      if (llvm::sys::fs::status(pch_file, pch_status))
+         return false;
+      auto deps = llvm::MemoryBuffer::getFile(deps_file);
+      if (!deps)
+         return false;
+
+      llvm::StringRef text = deps.get()->getBuffer();
+      // skip the target of the rule
+      size_t pos = text.find(": ");
+      if (pos == llvm::StringRef::npos)
+         return false;
+
+      std::string dep;
+      const auto& check_dep = [&]() {
+         if (dep.empty())
+            return true;
+         llvm::sys::fs::file_status dep_status;
+         bool fresh = !llvm::sys::fs::status(dep, dep_status) &&
+                      dep_status.getLastModificationTime() <= pch_status.getLastModificationTime();
+         dep.clear();
+         return fresh;
+      };
+      for (pos += 2; pos < text.size(); pos++) {
+         char c = text[pos];
+         if (c == '\\' && pos + 1 < text.size() && (text[pos+1] == ' ' || text[pos+1] == '#')) {
+            dep += text[++pos];
+         } else if (c == '\\' && pos + 1 < text.size() && text[pos+1] == '\n') {
+            ++pos;
+         } else if (c == ' ' || c == '\n') {
+            if (!check_dep())
+               return false;
+         } else {
+            dep += c;
+         }
+      }
+      return check_dep();
+   }
+
+   // Return the precompiled header for the compiler options `copts`, building it in `dir` if it
+   // doesn't exist yet or is out of date. Headers are keyed by the options and the CDT version.
+   inline llvm::Optional<std::string> get_or_build(const std::vector<std::string>& copts, const std::string& dir, const std::string& version) {
+      auto opts = header_options(copts);
+
+      llvm::MD5 hash;
+      hash.update(version);
+      hash.update(llvm::StringRef("\0", 1));
+      hash.update(header_source);
+      for (const auto& opt : opts) {
+         hash.update(llvm::StringRef("\0", 1));
+         hash.update(opt);
+      }
+      llvm::MD5::MD5Result result;
+      hash.final(result);
+      const std::string key = result.digest().str().str();
+
+      if (llvm::sys::fs::create_directories(dir)) {
+         llvm::errs() << "warning: failed to create the precompiled header directory " << dir << "\n";
+         return llvm::None;
+      }
+
+      const std::string base = dir + llvm::sys::path::get_separator().str() + key;
+      const std::string header_file = base + ".hpp";
+      const std::string pch_file = base + ".pch";
+      const std::string deps_file = base + ".d";
+      if (is_up_to_date(pch_file, deps_file))
+         return pch_file;
+
+      // the header is only written once, rewriting it would invalidate headers in use by other compiles
+      if (!llvm::sys::fs::exists(header_file)) {
+         std::ofstream out(header_file);
+         out << header_source;
+         if (!out) {
+            llvm::errs() << "warning: failed to write " << header_file << "\n";
+            return llvm::None;
+         }
+      }
+
+      // build into unique files and rename them so concurrent builds never see a partial header
+      llvm::SmallString<128> tmp_pch, tmp_deps;
+      llvm::sys::fs::createUniqueFile(base + "-%%%%%%.pch", tmp_pch);
+      llvm::sys::fs::createUniqueFile(base + "-%%%%%%.d", tmp_deps);
+      opts.insert(opts.end(), { "-xc++-header", header_file, "-o", tmp_pch.str().str(), "-MD", "-MF", tmp_deps.str().str() });
+      if (!eosio::cdt::environment::exec_subprogram("clang-9", opts) ||
+          llvm::sys::fs::rename(tmp_deps, deps_file) ||
+          llvm::sys::fs::rename(tmp_pch, pch_file)) {
+         llvm::sys::fs::remove(tmp_pch);
+         llvm::sys::fs::remove(tmp_deps);
+         llvm::errs() << "warning: failed to build the precompiled header, compiling without it\n";
+         return llvm::None;
+      }
+      return pch_file;
+   }
+
+   // The default directory for precompiled headers, in the user's cache directory
+   inline std::string default_dir() {
+      llvm::SmallString<128> dir;
+      if (!llvm::sys::path::cache_directory(dir))
+         llvm::sys::path::system_temp_directory(true, dir);
+      llvm::sys::path::append(dir, "cdt", "pch");
+      return dir.str().str();
+   }
+}}} // ns eosio::cdt::pch
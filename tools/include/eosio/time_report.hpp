@@ -0,0 +1,165 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace eosio { namespace cdt { namespace time_report {
+
+   // A phase of the build, written as a complete event ("ph": "X") of the Chrome trace event format
+   struct event {
+      std::string name;
+      std::string category;
+      std::string detail;
+      int64_t     start_us;
+      int64_t     duration_us;
+      long        peak_rss_kb;
+   };
+
+   // Set for the tools started by a tool writing a report, they append their events to its report
+   static constexpr const char* nested_env = "CDT_TIME_REPORT_NESTED";
+
+   inline int64_t now_us() {
+      return std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+   }
+
+   // Peak resident set size of this process, or of the largest of its terminated subprocesses
+   inline long peak_rss_kb(bool subprocesses) {
+      struct rusage usage;
+      if (getrusage(subprocesses ? RUSAGE_CHILDREN : RUSAGE_SELF, &usage))
+         return 0;
+#ifdef __APPLE__
+      return usage.ru_maxrss / 1024;
+#else
+      return usage.ru_maxrss;
+#endif
+   }
+
+   inline std::string json_string(const std::string& s) {
+      std::string ret = "\"";
+      for (char c : s) {
+         if (c == '"' || c == '\\') {
+            ret += '\\';
+            ret += c;
+         } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            ret += buf;
+         } else {
+            ret += c;
+         }
+      }
+      return ret + "\"";
+   }
+
+   // Collects the phases of this process and writes them to the report when the process exits.
+   // Every tool of a build appends its events to the same file, the tool the user started
+   // truncates it first and closes the JSON array last, once its subprocesses have exited.
+   class recorder {
+      public:
+         static recorder& get() {
+            static recorder inst;
+            return inst;
+         }
+
+         void enable(const std::string& fn) {
+            path = fn;
+            top_level = getenv(nested_env) == nullptr;
+            if (top_level) {
+               std::ofstream(path, std::ios::trunc) << "[\n";
+               setenv(nested_env, "1", 1);
+            }
+         }
+
+         bool enabled()const { return !path.empty(); }
+
+         void add(event e) { events.push_back(std::move(e)); }
+
+         ~recorder() {
+            if (enabled())
+               flush();
+         }
+
+      private:
+         std::string        path;
+         bool               top_level = false;
+         std::vector<event> events;
+
+         void flush() {
+            std::stringstream ss;
+            for (const auto& e : events) {
+               ss << "{\"name\":" << json_string(e.name)
+                  << ",\"cat\":" << json_string(e.category)
+                  << ",\"ph\":\"X\",\"ts\":" << e.start_us
+                  << ",\"dur\":" << e.duration_us
+                  << ",\"pid\":" << getpid() << ",\"tid\":0"
+                  << ",\"args\":{\"peak_rss_kb\":" << e.peak_rss_kb
+                  << ",\"detail\":" << json_string(e.detail) << "}},\n";
+            }
+
+            if (!top_level) {
+               // appended in a single write, so the events of concurrent tools don't interleave
+               std::string out = ss.str();
+               struct stat st;
+               if (stat(path.c_str(), &st) || st.st_size == 0)
+                  out = "[\n" + out;
+               int fd = open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+               if (fd < 0)
+                  return;
+               ssize_t written = write(fd, out.data(), out.size());
+               (void)written;
+               close(fd);
+               return;
+            }
+
+            std::string report;
+            {
+               std::ifstream in(path);
+               std::stringstream content;
+               content << in.rdbuf();
+               report = content.str();
+            }
+            report += ss.str();
+            // the last event is followed by a separator
+            while (!report.empty() && (report.back() == '\n' || report.back() == ','))
+               report.pop_back();
+            if (report.empty())
+               report = "[";
+            std::ofstream(path, std::ios::trunc) << report << "\n]\n";
+         }
+   };
+
+   // Records the wall time and peak memory of a phase from its construction to its destruction
+   class scope {
+      public:
+         scope(std::string name, std::string category, std::string detail = "", bool subprocess = false)
+            : ev{std::move(name), std::move(category), std::move(detail), 0, 0, 0}, subprocess(subprocess) {
+            if (recorder::get().enabled())
+               ev.start_us = now_us();
+         }
+
+         ~scope() {
+            // not recorded if the report was enabled after the phase started
+            if (!recorder::get().enabled() || ev.start_us == 0)
+               return;
+            ev.duration_us = now_us() - ev.start_us;
+            ev.peak_rss_kb = peak_rss_kb(subprocess);
+            recorder::get().add(std::move(ev));
+         }
+
+      private:
+         event ev;
+         bool  subprocess;
+   };
+}}} // ns eosio::cdt::time_report
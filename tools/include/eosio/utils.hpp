@@ -1,5 +1,6 @@
 #pragma once
 
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/Support/Program.h"
@@ -13,6 +14,9 @@ extern char **environ;
 #endif
 
 #include "whereami/whereami.hpp"
+#include "time_report.hpp"
+#include <algorithm>
+#include <deque>
 #include <vector>
 #include <sstream>
 
@@ -171,6 +175,7 @@ struct environment {
       std::vector<llvm::StringRef> args;
       args.push_back(prog);
       args.insert(args.end(), options.begin(), options.end());
+      time_report::scope phase(prog, "subprocess", llvm::join(args, " "), true);
       std::string find_path = eosio::cdt::whereami::where();
       if (root)
          find_path = "/usr/bin";
@@ -189,5 +194,38 @@ struct environment {
       return true;
    }
 
+   // Run `prog` once per entry of `jobs`, with at most `max_jobs` instances running at a time.
+   // Returns false if any of the instances failed.
+   static bool exec_subprograms(const std::string prog, const std::vector<std::vector<std::string>>& jobs, unsigned max_jobs) {
+      const auto& path = llvm::sys::findProgramByName(prog.c_str(), {eosio::cdt::whereami::where()});
+      if (!path)
+         return false;
+
+      time_report::scope phase(prog, "subprocess", std::to_string(jobs.size()) + " jobs", true);
+      bool success = true;
+      std::deque<llvm::sys::ProcessInfo> running;
+      const auto& wait_oldest = [&]() {
+         llvm::sys::ProcessInfo pi = llvm::sys::Wait(running.front(), 0, true);
+         running.pop_front();
+         success &= pi.ReturnCode == 0;
+      };
+      for (const auto& options : jobs) {
+         if (running.size() >= std::max(max_jobs, 1u))
+            wait_oldest();
+         std::vector<llvm::StringRef> args;
+         args.push_back(prog);
+         args.insert(args.end(), options.begin(), options.end());
+         bool failed = false;
+         llvm::sys::ProcessInfo pi = llvm::sys::ExecuteNoWait(*path, args, llvm::None, {}, 0, nullptr, &failed);
+         if (failed)
+            success = false;
+         else
+            running.push_back(pi);
+      }
+      while (!running.empty())
+         wait_oldest();
+      return success;
+   }
+
 };
 }} // ns eosio::cdt
@@ -0,0 +1,46 @@
+"""
+Helpers for the check scripts of the toolchain tests, see Test.run_check.
+"""
+import json
+import os
+import shutil
+import subprocess
+import sys
+from typing import Dict, List
+
+cdt_path: str = os.environ["CDT_PATH"]
+test_cpp: str = os.environ["TEST_CPP"]
+
+
+def fail(message: str):
+    print(message, file=sys.stderr)
+    sys.exit(1)
+
+
+def check(condition: bool, message: str):
+    if not condition:
+        fail(message)
+
+
+def run(tool: str, *args: str, expect_success=True) -> subprocess.CompletedProcess:
+    """Runs the CDT tool `tool` in the current directory."""
+    res = subprocess.run([os.path.join(cdt_path, tool), *args], capture_output=True)
+    if expect_success and res.returncode != 0:
+        fail(f"{tool} {' '.join(args)} failed with {res.returncode}:\n{res.stderr.decode('utf-8')}")
+    return res
+
+
+def copy_source(name: str = None) -> str:
+    """Copies the test source to the current directory, returns its name."""
+    name = name or os.path.basename(test_cpp)
+    shutil.copyfile(test_cpp, name)
+    return name
+
+
+def time_report_events(path: str) -> List[Dict]:
+    """Reads the events of a -time-report file, failing the check if it isn't valid JSON."""
+    try:
+        with open(path) as f:
+            return json.load(f)
+    except (OSError, ValueError) as e:
+        fail(f"{path} is not a valid time report: {e}")
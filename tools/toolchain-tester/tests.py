@@ -7,7 +7,9 @@ import difflib
 import json
 import os
 import subprocess
+import sys
 import re
+import tempfile
 
 from printer import Printer as P
 from errors import TestFailure
@@ -77,7 +79,7 @@ class Test(ABC):
     def handle_expecteds(self, res: subprocess.CompletedProcess):
         expected = self.test_json["expected"]
 
-        if expected.get("exit-code"):
+        if "exit-code" in expected:
             exit_code = expected["exit-code"]
 
             if res.returncode != exit_code:
@@ -139,8 +141,35 @@ class Test(ABC):
                     "actual wasm did not match expected wasm", failing_test=self
                 )
 
+        if expected.get("check"):
+            self.run_check(expected["check"])
+
         self.success = True
 
+    def run_check(self, check: str):
+        """
+        Runs the check script `check`, found next to the test, in an empty directory of its own.
+        The script gets the CDT binaries in $CDT_PATH and the test source in $TEST_CPP, it fails
+        the test by exiting with a non-zero code.
+        """
+        env = dict(os.environ)
+        env["CDT_PATH"] = self.test_suite.cdt_path
+        env["TEST_CPP"] = self.cpp_file
+        tester_dir = os.path.dirname(os.path.abspath(__file__))
+        env["PYTHONPATH"] = os.pathsep.join(filter(None, [tester_dir, env.get("PYTHONPATH")]))
+
+        script = os.path.join(self.test_suite.directory, check)
+        with tempfile.TemporaryDirectory() as work_dir:
+            res = subprocess.run([sys.executable, script], cwd=work_dir, env=env, capture_output=True)
+
+        P.print(res.stdout.decode("utf-8").strip(), verbose=True)
+        if res.returncode != 0:
+            self.success = False
+            raise TestFailure(
+                f"check {check} failed: {res.stderr.decode('utf-8').strip()}",
+                failing_test=self,
+            )
+
     def __repr__(self):
         return self.__str__()
 